@@ -0,0 +1,50 @@
+#include <iostream>
+#include <stdexcept>
+#include "src/benchmark/Benchmark.h"
+
+using namespace std;
+
+// Standalone benchmark runner: no menu, reproducible, machine-readable output.
+// Build: g++ -std=c++17 -O2 -pthread bench_main.cpp src/benchmark/benchmark.cpp -o bench
+int main(int argc, char **argv)
+{
+    BenchmarkHarness::Options options;
+    try
+    {
+        options = BenchmarkHarness::parse_args(argc, argv);
+    }
+    catch (const invalid_argument &e)
+    {
+        cerr << e.what() << "\n"
+             << BenchmarkHarness::usage(argv[0]);
+        return 2;
+    }
+    if (options.help)
+    {
+        cout << BenchmarkHarness::usage(argv[0]);
+        return 0;
+    }
+
+    BenchmarkHarness harness(options);
+    try
+    {
+        register_harness_benchmarks(harness);
+    }
+    catch (const runtime_error &e) // unreadable --trace file
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+
+    if (options.list_only)
+    {
+        for (const string &name : harness.case_names())
+            cout << name << "\n";
+        return 0;
+    }
+
+    harness.run();
+    if (options.legacy)
+        run_all_benchmarks();
+    return 0;
+}
@@ -15,6 +15,7 @@ int main()
         cout << "1. Run unit tests\n";
         cout << "2. Run benchmarks\n";
         cout << "3. Interactive mode\n";
+        cout << "4. Run large benchmarks (100M+ elements, several GB RAM)\n";
         cout << "0. Exit\n";
         cout << "Select: ";
 
@@ -33,6 +34,8 @@ int main()
             run_all_benchmarks();
         else if (opt == 3)
             run_interactive();
+        else if (opt == 4)
+            run_large_benchmarks();
         else
             break;
     }
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../cache/CacheManager.h"
+#include "../data_structures/Sequence.h"
+#include "PerfCounters.h"
+
+/**
+ * @brief Compact binary file of cache keys, for capturing and replaying traffic.
+ *
+ * Layout: the 8 bytes "DCTRACE1", the key count as a little-endian uint64,
+ * then every key as the zigzag-encoded difference to the previous key in
+ * LEB128 (7 bits per byte). Scans and clustered ids take one byte per
+ * request, random 32-bit ids at most five. Byte order is fixed, so a trace
+ * written on one machine reads the same on any other.
+ */
+class AccessTrace
+{
+private:
+    static constexpr char MAGIC[8] = {'D', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    static void put_varint(std::vector<uint8_t> &out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static uint64_t get_varint(const std::vector<uint8_t> &in, size_t &pos, const std::string &path)
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (pos >= in.size())
+                throw std::runtime_error("AccessTrace: " + path + " is truncated");
+            uint8_t b = in[pos++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return v;
+        }
+        throw std::runtime_error("AccessTrace: " + path + " has a malformed record");
+    }
+
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+public:
+    static void write(const std::string &path, const Sequence<int> &keys)
+    {
+        std::vector<uint8_t> bytes(MAGIC, MAGIC + 8);
+        uint64_t count = keys.get_size();
+        for (int i = 0; i < 8; ++i)
+            bytes.push_back(static_cast<uint8_t>(count >> (8 * i)));
+        bytes.reserve(16 + keys.get_size() * 2);
+
+        int64_t prev = 0;
+        for (int key : keys)
+        {
+            put_varint(bytes, zigzag(key - prev));
+            prev = key;
+        }
+
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f)
+            throw std::runtime_error("AccessTrace: cannot create " + path);
+        size_t written = std::fwrite(bytes.data(), 1, bytes.size(), f);
+        std::fclose(f);
+        if (written != bytes.size())
+            throw std::runtime_error("AccessTrace: write failed for " + path);
+    }
+
+    static Sequence<int> read(const std::string &path)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f)
+            throw std::runtime_error("AccessTrace: cannot open " + path);
+        std::vector<uint8_t> bytes;
+        uint8_t chunk[1 << 16];
+        size_t got;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + got);
+        std::fclose(f);
+
+        if (bytes.size() < 16 || !std::equal(MAGIC, MAGIC + 8, bytes.begin()))
+            throw std::runtime_error("AccessTrace: " + path + " is not a trace file");
+        uint64_t count = 0;
+        for (int i = 0; i < 8; ++i)
+            count |= static_cast<uint64_t>(bytes[8 + i]) << (8 * i);
+        // every record takes at least one byte
+        if (count > bytes.size() - 16)
+            throw std::runtime_error("AccessTrace: " + path + " is truncated");
+
+        Sequence<int> keys;
+        keys.reserve(count);
+        size_t pos = 16;
+        int64_t prev = 0;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            int64_t key = prev + unzigzag(get_varint(bytes, pos, path));
+            if (key < INT32_MIN || key > INT32_MAX)
+                throw std::runtime_error("AccessTrace: " + path + " has a malformed record");
+            keys.push_back(static_cast<int>(key));
+            prev = key;
+        }
+        if (pos != bytes.size())
+            throw std::runtime_error("AccessTrace: " + path + " has trailing data");
+        return keys;
+    }
+
+    // One decimal key per line, e.g. ids cut out of a request log; blank lines are skipped
+    static Sequence<int> read_text(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in)
+            throw std::runtime_error("AccessTrace: cannot open " + path);
+        Sequence<int> keys;
+        std::string line;
+        size_t line_no = 0;
+        while (std::getline(in, line))
+        {
+            ++line_no;
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            size_t used = 0;
+            long long v = 0;
+            try
+            {
+                v = std::stoll(line, &used);
+            }
+            catch (const std::exception &)
+            {
+                used = 0;
+            }
+            if (used == 0 || line.find_first_not_of(" \t\r", used) != std::string::npos || v < INT32_MIN || v > INT32_MAX)
+                throw std::runtime_error("AccessTrace: " + path + ":" + std::to_string(line_no) + " is not a key");
+            keys.push_back(static_cast<int>(v));
+        }
+        return keys;
+    }
+
+    /**
+     * Renumber arbitrary ids to 0..distinct-1 in order of first appearance,
+     * the record positions CacheManager::get works with. Returns the number of
+     * distinct keys, i.e. the data size to initialize the cache with.
+     */
+    static size_t compact_keys(Sequence<int> &keys)
+    {
+        std::unordered_map<int, int> ids;
+        ids.reserve(keys.get_size() / 4 + 16);
+        for (int &key : keys)
+        {
+            auto it = ids.emplace(key, static_cast<int>(ids.size())).first;
+            key = it->second;
+        }
+        return ids.size();
+    }
+};
+
+struct ReplayResult
+{
+    size_t requests;
+    size_t hits;
+    size_t misses;
+    double hit_rate; // percent, like CacheStats
+    double elapsed_ms;
+    double ns_per_request;
+
+    ReplayResult() : requests(0), hits(0), misses(0), hit_rate(0.0), elapsed_ms(0.0), ns_per_request(0.0) {}
+};
+
+/**
+ * Issue keys[begin, end) against `cache` through get(), in order, and report
+ * hits and timing for just that range (also a PerfCounterScope). The cache is not reset first, so
+ * replaying the phases of a Workload one after another gives per-phase
+ * numbers for a cache that carries its state across phase boundaries.
+ */
+template <typename T>
+ReplayResult replay_trace(CacheManager<T> &cache, const Sequence<int> &keys, size_t begin = 0, size_t end = SIZE_MAX)
+{
+    end = std::min(end, keys.get_size());
+    if (begin > end)
+        throw std::out_of_range("replay_trace: range out of bounds");
+
+    CacheStats before = cache.get_statistics();
+    auto start = std::chrono::steady_clock::now();
+    {
+        PerfCounterScope perf;
+        for (size_t i = begin; i < end; ++i)
+            cache.get(keys[i]);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    CacheStats after = cache.get_statistics();
+
+    ReplayResult r;
+    r.requests = end - begin;
+    r.hits = after.hits - before.hits;
+    r.misses = after.misses - before.misses;
+    r.hit_rate = r.requests ? 100.0 * r.hits / r.requests : 0.0;
+    r.elapsed_ms = std::chrono::duration<double, std::milli>(finish - start).count();
+    r.ns_per_request = r.requests ? r.elapsed_ms * 1e6 / r.requests : 0.0;
+    return r;
+}
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "PerfCounters.h"
+
+// One named number produced by a benchmark run, e.g. {"lookup_ms", 12.5}
+struct Measurement
+{
+    std::string metric;
+    double value;
+};
+
+using Measurements = std::vector<Measurement>;
+
+// Summary of the repetitions of one metric
+struct SampleStats
+{
+    size_t count;
+    double mean;
+    double median;
+    double stddev; // sample standard deviation (n - 1)
+    double min;
+    double max;
+    double ci95_low; // 95% confidence interval of the mean (Student's t)
+    double ci95_high;
+
+    SampleStats() : count(0), mean(0), median(0), stddev(0), min(0), max(0), ci95_low(0), ci95_high(0) {}
+
+    static SampleStats from(std::vector<double> samples)
+    {
+        SampleStats s;
+        s.count = samples.size();
+        if (samples.empty())
+            return s;
+
+        std::sort(samples.begin(), samples.end());
+        size_t n = samples.size();
+        s.min = samples.front();
+        s.max = samples.back();
+        s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+
+        double sum = 0.0;
+        for (double v : samples)
+            sum += v;
+        s.mean = sum / n;
+
+        if (n > 1)
+        {
+            double sq = 0.0;
+            for (double v : samples)
+                sq += (v - s.mean) * (v - s.mean);
+            s.stddev = std::sqrt(sq / (n - 1));
+        }
+        double half = n > 1 ? t_critical_95(n - 1) * s.stddev / std::sqrt(static_cast<double>(n)) : 0.0;
+        s.ci95_low = s.mean - half;
+        s.ci95_high = s.mean + half;
+        return s;
+    }
+
+    // Two-sided 95% critical value of Student's t for `df` degrees of freedom
+    static double t_critical_95(size_t df)
+    {
+        static const double table[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                         2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                         2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (df == 0)
+            return 0.0;
+        return df <= 30 ? table[df - 1] : 1.96;
+    }
+};
+
+/**
+ * @brief Runs registered benchmark cases reproducibly and summarises them.
+ *
+ * Every case receives the same fixed seed on every run, so all repetitions
+ * see the identical workload and only the timing varies. Each case runs
+ * `warmup` times untimed (page faults, caches, lazy allocations), then
+ * `repetitions` times; for every metric it reports median, mean, standard
+ * deviation, min/max and a 95% confidence interval of the mean. Results go
+ * to the console, to <out>.csv (one row per case and metric) and to
+ * <out>.json with the run configuration.
+ *
+ * A case does its own setup and times only what it measures (see time_ms),
+ * returning the metrics for that one run. The measured regions are also
+ * PerfCounterScopes: where hardware counters are available, every case gets
+ * perf_* metrics (cycles, instructions, cache/branch/TLB misses, IPC) summed
+ * over its regions, reported like any other metric.
+ */
+class BenchmarkHarness
+{
+public:
+    struct Options
+    {
+        int repetitions = 7;
+        int warmup = 1;
+        uint32_t seed = 42;
+        std::string filter; // run only cases whose name contains this
+        std::string out = "benchmark_results";
+        bool list_only = false;
+        bool legacy = false; // also run the original run_all_benchmarks() suite
+        std::string trace;   // AccessTrace file to replay as an extra case
+        size_t trace_cache = 1000;
+        bool pin_threads = false; // pin worker threads of multi-threaded cases to cores
+        bool perf = true;         // hardware counters around the measured regions, where available
+        bool help = false;
+    };
+
+    struct CaseResult
+    {
+        std::string name;
+        std::vector<std::pair<std::string, SampleStats>> metrics;
+    };
+
+    using CaseFn = std::function<Measurements(uint32_t seed)>;
+
+private:
+    Options options;
+    std::vector<std::pair<std::string, CaseFn>> cases;
+    std::vector<CaseResult> results;
+
+    static std::string json_escape(const std::string &s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) < 0x20)
+                continue;
+            out += c;
+        }
+        return out;
+    }
+
+    static std::string json_number(double v)
+    {
+        if (!std::isfinite(v))
+            return "null";
+        std::ostringstream os;
+        os << std::setprecision(9) << v;
+        return os.str();
+    }
+
+    static int parse_int(const std::string &flag, const std::string &value, int min_value)
+    {
+        size_t used = 0;
+        int v = 0;
+        try
+        {
+            v = std::stoi(value, &used);
+        }
+        catch (const std::exception &)
+        {
+            used = 0;
+        }
+        if (used != value.size() || v < min_value)
+            throw std::invalid_argument(flag + " expects an integer >= " + std::to_string(min_value) + ", got '" + value + "'");
+        return v;
+    }
+
+public:
+    BenchmarkHarness() {}
+    explicit BenchmarkHarness(const Options &opts) : options(opts) {}
+
+    static Options parse_args(int argc, char **argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument(arg + " needs a value");
+                return argv[++i];
+            };
+
+            if (arg == "--reps")
+                o.repetitions = parse_int(arg, value(), 1);
+            else if (arg == "--warmup")
+                o.warmup = parse_int(arg, value(), 0);
+            else if (arg == "--seed")
+                o.seed = static_cast<uint32_t>(parse_int(arg, value(), 0));
+            else if (arg == "--filter")
+                o.filter = value();
+            else if (arg == "--out")
+                o.out = value();
+            else if (arg == "--trace")
+                o.trace = value();
+            else if (arg == "--cache")
+                o.trace_cache = static_cast<size_t>(parse_int(arg, value(), 1));
+            else if (arg == "--no-perf")
+                o.perf = false;
+            else if (arg == "--pin")
+                o.pin_threads = true;
+            else if (arg == "--list")
+                o.list_only = true;
+            else if (arg == "--legacy")
+                o.legacy = true;
+            else if (arg == "--help" || arg == "-h")
+                o.help = true;
+            else
+                throw std::invalid_argument("unknown option " + arg);
+        }
+        return o;
+    }
+
+    static std::string usage(const std::string &program)
+    {
+        return "usage: " + program + " [--reps N] [--warmup N] [--seed S] [--filter TEXT] [--out PREFIX] [--trace FILE [--cache N]] [--pin] [--no-perf] [--list] [--legacy]\n"
+                                     "  --reps N       timed repetitions per case (default 7)\n"
+                                     "  --warmup N     untimed runs before them (default 1)\n"
+                                     "  --seed S       workload seed, the same for every repetition (default 42)\n"
+                                     "  --filter TEXT  only cases whose name contains TEXT\n"
+                                     "  --out PREFIX   write PREFIX.csv and PREFIX.json (default benchmark_results)\n"
+                                     "  --trace FILE   also replay an AccessTrace file against CacheManager\n"
+                                     "  --cache N      cache capacity for --trace (default 1000)\n"
+                                     "  --pin          pin the threads of multi-threaded cases to CPU cores\n"
+                                     "  --no-perf      do not read hardware performance counters\n"
+                                     "  --list         print the case names and exit\n"
+                                     "  --legacy       afterwards run the full interactive-menu benchmark suite\n";
+    }
+
+    const Options &get_options() const { return options; }
+
+    void add(const std::string &name, CaseFn fn) { cases.emplace_back(name, std::move(fn)); }
+
+    // Wall time of f() in milliseconds; f() is also a perf counter region
+    template <typename F>
+    static double time_ms(F &&f)
+    {
+        PerfCounterScope perf;
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // perf_<event> metrics for the regions counted since the last take(); none if nothing was counted
+    static Measurements take_perf_counters()
+    {
+        PerfCounters::Sample s = PerfCounters::session().take();
+        Measurements m;
+        if (s.regions == 0)
+            return m;
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e)
+            if (s.valid[e])
+                m.push_back({std::string("perf_") + PerfCounters::event_name(e), s.value[e]});
+        if (s.valid[PerfCounters::CYCLES] && s.valid[PerfCounters::INSTRUCTIONS] && s.value[PerfCounters::CYCLES] > 0)
+            m.push_back({"perf_ipc", s.value[PerfCounters::INSTRUCTIONS] / s.value[PerfCounters::CYCLES]});
+        return m;
+    }
+
+    std::vector<std::string> case_names() const
+    {
+        std::vector<std::string> names;
+        for (const auto &c : cases)
+            if (options.filter.empty() || c.first.find(options.filter) != std::string::npos)
+                names.push_back(c.first);
+        return names;
+    }
+
+    const std::vector<CaseResult> &run()
+    {
+        results.clear();
+        std::cout << "seed " << options.seed << ", " << options.warmup << " warm-up + " << options.repetitions
+                  << " timed runs per case\n";
+        PerfCounters &perf = PerfCounters::session();
+        if (options.perf && perf.enable())
+        {
+            std::cout << "perf counters:";
+            for (const std::string &e : perf.available_events())
+                std::cout << " " << e;
+            std::cout << "\n\n";
+        }
+        else
+        {
+            perf.disable();
+            std::cout << (options.perf ? "perf counters unavailable\n\n" : "\n");
+        }
+        std::cout << std::left << std::setw(44) << "case" << std::setw(22) << "metric" << std::setw(16) << "median"
+                  << std::setw(14) << "stddev" << "95% CI of mean\n";
+
+        for (const auto &c : cases)
+        {
+            if (!options.filter.empty() && c.first.find(options.filter) == std::string::npos)
+                continue;
+
+            for (int i = 0; i < options.warmup; ++i)
+                c.second(options.seed);
+
+            // metric order follows the first run
+            std::vector<std::pair<std::string, std::vector<double>>> samples;
+            for (int r = 0; r < options.repetitions; ++r)
+            {
+                PerfCounters::session().take(); // drop what warm-ups or a previous case counted
+                Measurements run = c.second(options.seed);
+                Measurements counters = take_perf_counters();
+                run.insert(run.end(), counters.begin(), counters.end());
+                for (const Measurement &m : run)
+                {
+                    auto it = std::find_if(samples.begin(), samples.end(), [&](const std::pair<std::string, std::vector<double>> &s)
+                                           { return s.first == m.metric; });
+                    if (it == samples.end())
+                    {
+                        samples.emplace_back(m.metric, std::vector<double>());
+                        it = samples.end() - 1;
+                    }
+                    it->second.push_back(m.value);
+                }
+            }
+
+            CaseResult result;
+            result.name = c.first;
+            for (auto &s : samples)
+            {
+                SampleStats stats = SampleStats::from(s.second);
+                std::cout << std::left << std::setw(44) << c.first << std::setw(22) << s.first << std::fixed
+                          << std::setprecision(3) << std::setw(16) << stats.median << std::setw(14) << stats.stddev
+                          << "[" << stats.ci95_low << ", " << stats.ci95_high << "]\n";
+                result.metrics.emplace_back(s.first, stats);
+            }
+            results.push_back(result);
+        }
+
+        write_csv(options.out + ".csv");
+        write_json(options.out + ".json");
+        std::cout << "\nwritten: " << options.out << ".csv, " << options.out << ".json\n";
+        return results;
+    }
+
+    void write_csv(const std::string &path) const
+    {
+        std::ofstream out(path);
+        out << "case,metric,count,median,mean,stddev,min,max,ci95_low,ci95_high\n";
+        for (const CaseResult &r : results)
+            for (const auto &m : r.metrics)
+            {
+                const SampleStats &s = m.second;
+                out << r.name << "," << m.first << "," << s.count << "," << s.median << "," << s.mean << ","
+                    << s.stddev << "," << s.min << "," << s.max << "," << s.ci95_low << "," << s.ci95_high << "\n";
+            }
+    }
+
+    void write_json(const std::string &path) const
+    {
+        std::ofstream out(path);
+        out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"warmup\": " << options.warmup
+            << ", \"repetitions\": " << options.repetitions << ", \"filter\": \"" << json_escape(options.filter)
+            << "\", \"hardware_threads\": " << std::thread::hardware_concurrency() << ", \"perf_events\": [";
+        std::vector<std::string> events = PerfCounters::session().available_events();
+        for (size_t i = 0; i < events.size(); ++i)
+            out << (i ? ", " : "") << "\"" << events[i] << "\"";
+        out << "]"
+#ifdef __VERSION__
+            << ", \"compiler\": \"" << json_escape(__VERSION__) << "\""
+#endif
+            << "},\n  \"cases\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const CaseResult &r = results[i];
+            out << (i ? "," : "") << "\n    {\"name\": \"" << json_escape(r.name) << "\", \"metrics\": {";
+            for (size_t j = 0; j < r.metrics.size(); ++j)
+            {
+                const SampleStats &s = r.metrics[j].second;
+                out << (j ? ", " : "") << "\n      \"" << json_escape(r.metrics[j].first) << "\": {"
+                    << "\"count\": " << s.count << ", \"median\": " << json_number(s.median)
+                    << ", \"mean\": " << json_number(s.mean) << ", \"stddev\": " << json_number(s.stddev)
+                    << ", \"min\": " << json_number(s.min) << ", \"max\": " << json_number(s.max)
+                    << ", \"ci95\": [" << json_number(s.ci95_low) << ", " << json_number(s.ci95_high) << "]}";
+            }
+            out << "}}";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Heap accounting through the global operator new/delete replaced in
+ * benchmark.cpp, so it covers every container, node and string the program
+ * allocates. Sizes are the allocator's real block sizes (malloc_usable_size
+ * on glibc), not the requested ones. Without glibc only allocation counts and
+ * requested bytes are tracked; live and peak bytes stay 0.
+ *
+ * Counters are process-wide: measure with other threads idle.
+ */
+struct MemorySnapshot
+{
+    size_t allocations;
+    size_t deallocations;
+    size_t allocated_bytes; // total handed out so far
+    size_t live_bytes;      // currently allocated
+    size_t peak_live_bytes; // high-water mark since the last reset_peak_memory()
+};
+
+MemorySnapshot memory_snapshot();
+
+// Restart the high-water mark from the current live bytes
+void reset_peak_memory();
+
+// false when live/peak bytes are not tracked on this platform
+bool memory_accounting_exact();
+
+// Resident set from /proc (Linux), 0 elsewhere; does not allocate through operator new
+size_t current_rss_bytes();
+size_t peak_rss_bytes();
+void reset_peak_rss();
+
+/**
+ * @brief What the code between construction and report() allocated.
+ *
+ *     MemoryScope scope;
+ *     Dictionary<int, int> dict;
+ *     dict.insert_bulk(keys, keys);
+ *     MemoryUsage used = scope.report(); // used.retained_bytes = the dictionary
+ *
+ * Resets the peak on construction, so nested or overlapping scopes disturb
+ * each other's peak_bytes.
+ */
+struct MemoryUsage
+{
+    size_t allocations;
+    size_t deallocations;
+    size_t allocated_bytes; // everything allocated in the scope, freed or not
+    size_t retained_bytes;  // still live at report(): the footprint of what was built
+    size_t peak_bytes;      // highest live total above the starting point, e.g. during a rehash
+    size_t rss_bytes;       // growth of the resident set; pages, not blocks
+};
+
+class MemoryScope
+{
+private:
+    MemorySnapshot start;
+    size_t start_rss;
+
+public:
+    MemoryScope()
+    {
+        reset_peak_memory();
+        start = memory_snapshot();
+        start_rss = current_rss_bytes();
+    }
+
+    MemoryUsage report() const
+    {
+        MemorySnapshot now = memory_snapshot();
+        size_t rss = current_rss_bytes();
+        MemoryUsage u;
+        u.allocations = now.allocations - start.allocations;
+        u.deallocations = now.deallocations - start.deallocations;
+        u.allocated_bytes = now.allocated_bytes - start.allocated_bytes;
+        u.retained_bytes = now.live_bytes > start.live_bytes ? now.live_bytes - start.live_bytes : 0;
+        u.peak_bytes = now.peak_live_bytes > start.live_bytes ? now.peak_live_bytes - start.live_bytes : 0;
+        u.rss_bytes = rss > start_rss ? rss - start_rss : 0;
+        return u;
+    }
+};
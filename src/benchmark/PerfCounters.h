@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_LINUX 1
+#endif
+
+/**
+ * @brief Hardware event counters (Linux perf_event_open) around measured code.
+ *
+ * One process-wide session (session()) owns a counter per event. Each
+ * PerfCounterScope adds what happened during its lifetime to the session
+ * totals; take() hands them out and starts over. Events are opened one by
+ * one, so a machine without, say, an LLC event still gets the others; where
+ * perf_event_open is missing, forbidden (perf_event_paranoid, containers) or
+ * there is no PMU (many VMs), events are simply unavailable and scopes do
+ * nothing.
+ *
+ * Counts are user-space only, for the calling thread plus threads it starts
+ * after enable(). When the kernel has to multiplex more events than the PMU
+ * has counters, values are scaled up by enabled/running time.
+ */
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        DTLB_MISSES,
+        PAGE_FAULTS,
+        EVENT_COUNT
+    };
+
+    struct Sample
+    {
+        bool valid[EVENT_COUNT];
+        double value[EVENT_COUNT];
+        size_t regions; // scopes that contributed
+
+        Sample() : regions(0)
+        {
+            for (int e = 0; e < EVENT_COUNT; ++e)
+            {
+                valid[e] = false;
+                value[e] = 0.0;
+            }
+        }
+    };
+
+private:
+    int fds[EVENT_COUNT];
+    bool is_enabled;
+    int depth; // nested scopes count once
+    Sample totals;
+
+#ifdef PERF_COUNTERS_LINUX
+    static int open_event(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static uint64_t cache_miss(uint64_t cache) { return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16); }
+#endif
+
+    PerfCounters() : is_enabled(false), depth(0)
+    {
+        for (int &fd : fds)
+            fd = -1;
+    }
+
+public:
+    ~PerfCounters() { disable(); }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    static PerfCounters &session()
+    {
+        static PerfCounters counters;
+        return counters;
+    }
+
+    static const char *event_name(int e)
+    {
+        static const char *names[EVENT_COUNT] = {"cycles", "instructions", "l1d_misses", "llc_misses",
+                                                 "branch_misses", "dtlb_misses", "page_faults"};
+        return names[e];
+    }
+
+    // Open the counters; true if at least one event is available
+    bool enable()
+    {
+        disable();
+#ifdef PERF_COUNTERS_LINUX
+        fds[CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[L1D_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+        fds[LLC_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+        fds[BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[DTLB_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+        fds[PAGE_FAULTS] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+        is_enabled = !available_events().empty();
+        totals = Sample();
+        return is_enabled;
+    }
+
+    void disable()
+    {
+#ifdef PERF_COUNTERS_LINUX
+        for (int &fd : fds)
+            if (fd >= 0)
+                ::close(fd);
+#endif
+        for (int &fd : fds)
+            fd = -1;
+        is_enabled = false;
+        depth = 0;
+    }
+
+    bool enabled() const { return is_enabled; }
+
+    std::vector<std::string> available_events() const
+    {
+        std::vector<std::string> names;
+        for (int e = 0; e < EVENT_COUNT; ++e)
+            if (fds[e] >= 0)
+                names.push_back(event_name(e));
+        return names;
+    }
+
+    void begin()
+    {
+        if (!is_enabled || depth++ > 0)
+            return;
+#ifdef PERF_COUNTERS_LINUX
+        for (int fd : fds)
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+    }
+
+    void end()
+    {
+        if (!is_enabled || depth == 0 || --depth > 0)
+            return;
+#ifdef PERF_COUNTERS_LINUX
+        for (int fd : fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < EVENT_COUNT; ++e)
+        {
+            uint64_t v[3]; // value, time enabled, time running
+            if (fds[e] < 0 || ::read(fds[e], v, sizeof(v)) != static_cast<ssize_t>(sizeof(v)))
+                continue;
+            double value = static_cast<double>(v[0]);
+            if (v[2] > 0 && v[2] < v[1])
+                value *= static_cast<double>(v[1]) / static_cast<double>(v[2]);
+            totals.valid[e] = true;
+            totals.value[e] += value;
+        }
+#endif
+        totals.regions++;
+    }
+
+    // Totals since enable() or the previous take()
+    Sample take()
+    {
+        Sample s = totals;
+        totals = Sample();
+        return s;
+    }
+};
+
+// RAII region counted by PerfCounters::session(); free when counters are off
+class PerfCounterScope
+{
+private:
+    bool open;
+
+public:
+    PerfCounterScope() : open(true) { PerfCounters::session().begin(); }
+    ~PerfCounterScope() { stop(); }
+
+    // End the region early, e.g. before the result it measured is reported
+    void stop()
+    {
+        if (!open)
+            return;
+        open = false;
+        PerfCounters::session().end();
+    }
+
+    PerfCounterScope(const PerfCounterScope &) = delete;
+    PerfCounterScope &operator=(const PerfCounterScope &) = delete;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../data_structures/Sequence.h"
+
+/**
+ * @brief Zipf distribution over ranks 0..n-1: P(k) is proportional to 1 / (k + 1)^skew.
+ *
+ * skew 0 is uniform, ~0.8-1.0 is typical of web and key-value traffic, above 1
+ * a handful of keys take most requests. Sampling inverts the cumulative
+ * distribution with a binary search (8 bytes per rank, exact for any skew).
+ */
+class ZipfDistribution
+{
+private:
+    std::vector<double> cdf;
+    double skew;
+
+public:
+    ZipfDistribution(size_t n, double skew) : skew(skew)
+    {
+        if (n == 0)
+            throw std::invalid_argument("ZipfDistribution: n must be > 0");
+        if (!(skew >= 0.0))
+            throw std::invalid_argument("ZipfDistribution: skew must be >= 0");
+        cdf.resize(n);
+        double sum = 0.0;
+        for (size_t k = 0; k < n; ++k)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+            cdf[k] = sum;
+        }
+    }
+
+    template <typename Gen>
+    size_t operator()(Gen &gen) const
+    {
+        double u = std::uniform_real_distribution<double>(0.0, cdf.back())(gen);
+        size_t k = static_cast<size_t>(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+        return std::min(k, cdf.size() - 1);
+    }
+
+    // Probability of rank k
+    double probability(size_t k) const
+    {
+        if (k >= cdf.size())
+            return 0.0;
+        return (k == 0 ? cdf[0] : cdf[k] - cdf[k - 1]) / cdf.back();
+    }
+
+    size_t get_size() const { return cdf.size(); }
+    double get_skew() const { return skew; }
+};
+
+/**
+ * @brief Builds a key access pattern for CacheManager out of phases.
+ *
+ * Keys are 0..key_space-1, i.e. record positions as CacheManager::get expects.
+ * Every call appends one phase, so mixed workloads are written as a chain:
+ *
+ *     Workload w(100000, seed);
+ *     w.zipf(500000, 0.99).scan(100000).shifting_hotspot(500000, 1000, 0.9, 50000);
+ *
+ * Popularity ranks (zipf, hotspots) are spread over the key space by a fixed
+ * seeded permutation, so the hot keys are not simply the lowest keys that
+ * CacheManager preloads. The same seed always produces the same requests.
+ */
+class Workload
+{
+public:
+    struct Phase
+    {
+        std::string name;
+        size_t begin; // [begin, end) in keys()
+        size_t end;
+    };
+
+private:
+    size_t key_space;
+    std::mt19937 gen;
+    std::vector<int> rank_to_key;
+    Sequence<int> pattern;
+    std::vector<Phase> phases;
+
+    void begin_phase(const std::string &name, size_t requests)
+    {
+        phases.push_back({name, pattern.get_size(), pattern.get_size() + requests});
+        pattern.reserve(pattern.get_size() + requests);
+    }
+
+public:
+    explicit Workload(size_t key_space, uint32_t seed = 42) : key_space(key_space), gen(seed)
+    {
+        if (key_space == 0 || key_space > static_cast<size_t>(INT32_MAX))
+            throw std::invalid_argument("Workload: key space must be in 1..INT32_MAX");
+        rank_to_key.resize(key_space);
+        for (size_t i = 0; i < key_space; ++i)
+            rank_to_key[i] = static_cast<int>(i);
+        std::shuffle(rank_to_key.begin(), rank_to_key.end(), gen);
+    }
+
+    // Every key equally likely
+    Workload &uniform(size_t requests)
+    {
+        begin_phase("uniform", requests);
+        std::uniform_int_distribution<size_t> dis(0, key_space - 1);
+        for (size_t i = 0; i < requests; ++i)
+            pattern.push_back(static_cast<int>(dis(gen)));
+        return *this;
+    }
+
+    // Zipf-distributed popularity with the given skew
+    Workload &zipf(size_t requests, double skew)
+    {
+        begin_phase("zipf-" + std::to_string(skew).substr(0, 4), requests);
+        ZipfDistribution dist(key_space, skew);
+        for (size_t i = 0; i < requests; ++i)
+            pattern.push_back(rank_to_key[dist(gen)]);
+        return *this;
+    }
+
+    // start, start+1, ... wrapping at the end of the key space; each key once per pass
+    Workload &scan(size_t requests, size_t start = 0)
+    {
+        begin_phase("scan", requests);
+        for (size_t i = 0; i < requests; ++i)
+            pattern.push_back(static_cast<int>((start + i) % key_space));
+        return *this;
+    }
+
+    // 0..loop_size-1 over and over; with loop_size > cache size LRU never hits
+    Workload &loop(size_t requests, size_t loop_size)
+    {
+        if (loop_size == 0 || loop_size > key_space)
+            throw std::invalid_argument("Workload::loop: loop size must be in 1..key space");
+        begin_phase("loop", requests);
+        for (size_t i = 0; i < requests; ++i)
+            pattern.push_back(static_cast<int>(i % loop_size));
+        return *this;
+    }
+
+    /**
+     * `hot_fraction` of requests go uniformly to a hot set of `hot_size` keys,
+     * the rest uniformly anywhere. Every `shift_every` requests the hot set
+     * moves on to the next `hot_size` ranks, so yesterday's favourites go cold.
+     */
+    Workload &shifting_hotspot(size_t requests, size_t hot_size, double hot_fraction, size_t shift_every)
+    {
+        if (hot_size == 0 || hot_size > key_space)
+            throw std::invalid_argument("Workload::shifting_hotspot: hot set must be in 1..key space");
+        if (!(hot_fraction >= 0.0 && hot_fraction <= 1.0))
+            throw std::invalid_argument("Workload::shifting_hotspot: hot fraction must be in [0, 1]");
+        if (shift_every == 0)
+            throw std::invalid_argument("Workload::shifting_hotspot: shift period must be > 0");
+
+        begin_phase("hotspot", requests);
+        std::bernoulli_distribution is_hot(hot_fraction);
+        std::uniform_int_distribution<size_t> in_hot(0, hot_size - 1);
+        std::uniform_int_distribution<size_t> anywhere(0, key_space - 1);
+        for (size_t i = 0; i < requests; ++i)
+        {
+            size_t base = (i / shift_every) * hot_size;
+            if (is_hot(gen))
+                pattern.push_back(rank_to_key[(base + in_hot(gen)) % key_space]);
+            else
+                pattern.push_back(static_cast<int>(anywhere(gen)));
+        }
+        return *this;
+    }
+
+    const Sequence<int> &keys() const { return pattern; }
+    const std::vector<Phase> &get_phases() const { return phases; }
+    size_t get_key_space() const { return key_space; }
+    size_t get_size() const { return pattern.get_size(); }
+};
@@ -2,123 +2,2532 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "../data_structures/Sequence.h"
 #include "../data_structures/Dictionary.h"
 #include "../data_structures/BTree.h"
+#include "../data_structures/BPlusTree.h"
+#include "../data_structures/RecordIndex.h"
+#include "../data_structures/ConcurrentBTree.h"
+#include "../data_structures/ConcurrentDictionary.h"
+#include "../data_structures/PagedBTree.h"
+#include "../data_structures/EytzingerIndex.h"
+#include "../data_structures/SegmentedSequence.h"
+#include "../data_structures/MappedSequence.h"
+#include "../data_structures/ParallelAlgorithms.h"
+#include "../data_structures/SimdSearch.h"
+#include "../cache/Person.h"
+#include "../cache/CompactPerson.h"
+#include "../cache/StringPool.h"
+#include "../cache/SlowStorage.h"
+#include "../cache/CacheManager.h"
+#include "Benchmark.h"
+#include "MemoryAccounting.h"
+#include "PerfCounters.h"
+#include "Workload.h"
+#include "AccessTrace.h"
+
+using namespace std;
+
+// Таймер
+long long ms_now()
+{
+    return chrono::duration_cast<chrono::milliseconds>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+long long us_now()
+{
+    return chrono::duration_cast<chrono::microseconds>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// ------------------------
+// Счётчики событий (PerfCounters) в CSV основного набора
+// ------------------------
+// Замеряемый участок: время в мкс, внутри — PerfCounterScope
+template <typename F>
+static long long timed_us(F &&f)
+{
+    PerfCounterScope perf;
+    long long t1 = us_now();
+    f();
+    return us_now() - t1;
+}
+
+// Колонки perf_* одинаковы на любой машине; недоступное событие остаётся пустым
+static string perf_csv_header()
+{
+    string header;
+    for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e)
+        header += string(",perf_") + PerfCounters::event_name(e);
+    return header + ",perf_ipc";
+}
+
+// Сумма по участкам, закрытым после предыдущего вызова (или perf_discard())
+static string perf_csv_fields()
+{
+    PerfCounters::Sample s = PerfCounters::session().take();
+    ostringstream fields;
+    for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e)
+    {
+        fields << ",";
+        if (s.valid[e])
+            fields << static_cast<long long>(s.value[e]);
+    }
+    fields << ",";
+    if (s.valid[PerfCounters::CYCLES] && s.valid[PerfCounters::INSTRUCTIONS] && s.value[PerfCounters::CYCLES] > 0)
+        fields << fixed << setprecision(3) << s.value[PerfCounters::INSTRUCTIONS] / s.value[PerfCounters::CYCLES];
+    return fields.str();
+}
+
+// Пустые perf_* колонки для строк, к которым счётчики не относятся
+static string perf_csv_blank() { return string(PerfCounters::EVENT_COUNT + 1, ','); }
+
+// Забыть то, что набрано до начала строки
+static void perf_discard() { PerfCounters::session().take(); }
+
+// ------------------------
+// Учёт кучи: глобальные operator new/delete считают вызовы и реальные размеры блоков
+// ------------------------
+static atomic<size_t> allocation_count{0};
+static atomic<size_t> deallocation_count{0};
+static atomic<size_t> allocated_bytes{0};
+static atomic<size_t> live_bytes{0};
+static atomic<size_t> peak_live_bytes{0};
+
+// noinline: иначе GCC видит free() рядом с new-выражением и предупреждает о несовпадении
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static void note_allocation(void *p, size_t requested)
+{
+#if defined(__GLIBC__)
+    (void)requested;
+    size_t bytes = malloc_usable_size(p);
+    size_t now = live_bytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    size_t peak = peak_live_bytes.load(memory_order_relaxed);
+    while (now > peak && !peak_live_bytes.compare_exchange_weak(peak, now, memory_order_relaxed))
+    {
+    }
+#else
+    (void)p;
+    size_t bytes = requested;
+#endif
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, memory_order_relaxed);
+}
+
+static void note_deallocation(void *p)
+{
+    if (!p)
+        return;
+    deallocation_count.fetch_add(1, memory_order_relaxed);
+#if defined(__GLIBC__)
+    live_bytes.fetch_sub(malloc_usable_size(p), memory_order_relaxed);
+#endif
+}
+
+BENCH_NOINLINE void *operator new(size_t bytes)
+{
+    if (void *p = malloc(bytes ? bytes : 1))
+    {
+        note_allocation(p, bytes);
+        return p;
+    }
+    throw bad_alloc();
+}
+
+BENCH_NOINLINE void *operator new[](size_t bytes) { return ::operator new(bytes); }
+BENCH_NOINLINE void operator delete(void *p) noexcept
+{
+    note_deallocation(p);
+    free(p);
+}
+BENCH_NOINLINE void operator delete[](void *p) noexcept { ::operator delete(p); }
+BENCH_NOINLINE void operator delete(void *p, size_t) noexcept { ::operator delete(p); }
+BENCH_NOINLINE void operator delete[](void *p, size_t) noexcept { ::operator delete(p); }
+
+#if defined(__GLIBC__)
+// выровненные (alignas > 16) объекты, например полосы блокировок ConcurrentDictionary
+BENCH_NOINLINE void *operator new(size_t bytes, align_val_t align)
+{
+    size_t a = static_cast<size_t>(align);
+    if (void *p = aligned_alloc(a, (max<size_t>(bytes, 1) + a - 1) / a * a))
+    {
+        note_allocation(p, bytes);
+        return p;
+    }
+    throw bad_alloc();
+}
+
+BENCH_NOINLINE void *operator new[](size_t bytes, align_val_t align) { return ::operator new(bytes, align); }
+BENCH_NOINLINE void operator delete(void *p, align_val_t) noexcept { ::operator delete(p); }
+BENCH_NOINLINE void operator delete[](void *p, align_val_t) noexcept { ::operator delete(p); }
+BENCH_NOINLINE void operator delete(void *p, size_t, align_val_t) noexcept { ::operator delete(p); }
+BENCH_NOINLINE void operator delete[](void *p, size_t, align_val_t) noexcept { ::operator delete(p); }
+#endif
+
+MemorySnapshot memory_snapshot()
+{
+    MemorySnapshot s;
+    s.allocations = allocation_count.load(memory_order_relaxed);
+    s.deallocations = deallocation_count.load(memory_order_relaxed);
+    s.allocated_bytes = allocated_bytes.load(memory_order_relaxed);
+    s.live_bytes = live_bytes.load(memory_order_relaxed);
+    s.peak_live_bytes = peak_live_bytes.load(memory_order_relaxed);
+    return s;
+}
+
+void reset_peak_memory() { peak_live_bytes.store(live_bytes.load(memory_order_relaxed), memory_order_relaxed); }
+
+bool memory_accounting_exact()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t allocations_now() { return allocation_count.load(memory_order_relaxed); }
+
+// Резидентная память процесса (Linux, /proc/self/statm); 0 там, где недоступно.
+// Через FILE*, а не ifstream: чтение не должно попадать в учёт operator new
+size_t current_rss_bytes()
+{
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long long pages_total = 0, pages_resident = 0;
+    int got = fscanf(statm, "%llu %llu", &pages_total, &pages_resident);
+    fclose(statm);
+    if (got != 2)
+        return 0;
+#ifndef _WIN32
+    long page = sysconf(_SC_PAGESIZE);
+#else
+    long page = 4096;
+#endif
+    return static_cast<size_t>(pages_resident) * static_cast<size_t>(page > 0 ? page : 4096);
+}
+
+// Пик RSS (VmHWM); reset_peak_rss() сбрасывает его через /proc/self/clear_refs
+// Тоже через FILE* и буфер на стеке
+size_t peak_rss_bytes()
+{
+    FILE *status = fopen("/proc/self/status", "r");
+    if (!status)
+        return 0;
+    char line[256];
+    unsigned long long kb = 0;
+    while (fgets(line, sizeof(line), status))
+        if (sscanf(line, "VmHWM: %llu", &kb) == 1)
+            break;
+    fclose(status);
+    return static_cast<size_t>(kb) * 1024;
+}
+
+void reset_peak_rss()
+{
+    FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+    if (!clear_refs)
+        return;
+    fputs("5", clear_refs);
+    fclose(clear_refs);
+}
+
+// ------------------------
+// Бенчмарк для Dictionary и BTree
+// ------------------------
+struct BenchResult
+{
+    int n;
+    long long insert_dict_ms;
+    long long search_dict_ms;
+    long long insert_tree_ms;
+    long long search_tree_ms;
+    MemoryUsage mem_dict; // построение: сохранённые байты, пик, число выделений
+    MemoryUsage mem_tree;
+    string perf;          // perf_* колонки: сумма по четырём замерам
+};
+
+BenchResult run_single(int n)
+{
+    BenchResult r;
+    r.n = n;
+
+    Sequence<int> data;
+
+    for (int i = 0; i < n; ++i)
+        data.push_back(i);
+    perf_discard();
+
+    // ---------------------------
+    // Dictionary — вставка
+    // ---------------------------
+    MemoryScope dict_scope;
+    Dictionary<int, int> dict;
+
+    r.insert_dict_ms = timed_us([&]
+                                { dict.insert_bulk(data, data); }) / 1000;
+    r.mem_dict = dict_scope.report();
+
+    // поиск 1000 случайных значений или всех n если n<1000
+    r.search_dict_ms = timed_us([&]
+                                {
+        for (int i = 0; i < min(n, 1000); ++i)
+        {
+            int key = i % n;
+            dict.find(key);
+        } }) / 1000;
+
+    // ---------------------------
+    // BTree — вставка
+    // ---------------------------
+    MemoryScope tree_scope;
+    BTree<int> tree;
+
+    r.insert_tree_ms = timed_us([&]
+                                {
+        for (int i = 0; i < n; ++i)
+            tree.insert(i); }) / 1000;
+    r.mem_tree = tree_scope.report();
+
+    // ---------------------------
+    // поиск
+    // ---------------------------
+    r.search_tree_ms = timed_us([&]
+                                {
+        for (int i = 0; i < min(n, 1000); ++i)
+        {
+            int key = i % n;
+            tree.search(key);
+        } }) / 1000;
+
+    r.perf = perf_csv_fields();
+    return r;
+}
+
+// ------------------------
+// BTree vs BPlusTree vs std::map
+// ------------------------
+// не даём компилятору выбросить результаты поиска
+static volatile long long benchmark_sink = 0;
+
+struct TreeBenchResult
+{
+    int n;
+    double btree_insert_ms, bplus_insert_ms, map_insert_ms;
+    double btree_search_ns, bplus_search_ns, map_search_ns;
+    string perf;
+};
+
+TreeBenchResult run_tree_comparison(int n)
+{
+    TreeBenchResult r;
+    r.n = n;
+
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+        keys[i] = i;
+    mt19937 gen(12345);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    vector<int> probes(1000000);
+    for (auto &p : probes)
+        p = keys[gen() % n];
+
+    long long sink = 0;
+    perf_discard();
+
+    BTree<int> btree;
+    r.btree_insert_ms = timed_us([&]
+                                 {
+        for (int k : keys)
+            btree.insert(k); }) / 1000.0;
+    r.btree_search_ns = timed_us([&]
+                                 {
+        for (int k : probes)
+            sink += *btree.search(k); }) * 1000.0 / probes.size();
+
+    BPlusTree<int, int> bplus;
+    r.bplus_insert_ms = timed_us([&]
+                                 {
+        for (int k : keys)
+            bplus.insert(k, k); }) / 1000.0;
+    r.bplus_search_ns = timed_us([&]
+                                 {
+        for (int k : probes)
+            sink += *bplus.find(k); }) * 1000.0 / probes.size();
+
+    map<int, int> m;
+    r.map_insert_ms = timed_us([&]
+                               {
+        for (int k : keys)
+            m.emplace(k, k); }) / 1000.0;
+    r.map_search_ns = timed_us([&]
+                               {
+        for (int k : probes)
+            sink += m.find(k)->second; }) * 1000.0 / probes.size();
+
+    benchmark_sink = sink;
+    r.perf = perf_csv_fields();
+    return r;
+}
+
+void run_tree_benchmarks()
+{
+    cout << "\n=========== BENCHMARK: BTree vs BPlusTree vs std::map ===========\n";
+    cout << "BPlusTree<int,int> node capacity: inner=" << BPlusTree<int, int>::INNER_CAPACITY
+         << " leaf=" << BPlusTree<int, int>::LEAF_CAPACITY << "\n";
+
+    vector<TreeBenchResult> results;
+    for (int n : {100000, 1000000})
+        results.push_back(run_tree_comparison(n));
+
+    cout << left << setw(10) << "n"
+         << setw(16) << "btree_ins ms" << setw(16) << "bplus_ins ms" << setw(16) << "map_ins ms"
+         << setw(16) << "btree_find ns" << setw(16) << "bplus_find ns" << setw(16) << "map_find ns" << "\n";
+    ofstream out("benchmark_trees.csv");
+    out << "n,btree_insert_ms,bplus_insert_ms,map_insert_ms,btree_search_ns,bplus_search_ns,map_search_ns" << perf_csv_header() << "\n";
+    for (auto &r : results)
+    {
+        cout << fixed << setprecision(1) << left << setw(10) << r.n
+             << setw(16) << r.btree_insert_ms << setw(16) << r.bplus_insert_ms << setw(16) << r.map_insert_ms
+             << setw(16) << r.btree_search_ns << setw(16) << r.bplus_search_ns << setw(16) << r.map_search_ns << "\n";
+        out << r.n << "," << r.btree_insert_ms << "," << r.bplus_insert_ms << "," << r.map_insert_ms << ","
+            << r.btree_search_ns << "," << r.bplus_search_ns << "," << r.map_search_ns << r.perf << "\n";
+    }
+}
+
+// ------------------------
+// Диапазонные запросы: пропускная способность
+// ------------------------
+void run_range_scan_benchmark(int n, int range_len, int scans)
+{
+    cout << "\n=========== BENCHMARK: Range scans (n=" << n << ", range=" << range_len << ") ===========\n";
+
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+        keys[i] = i;
+    mt19937 gen(2024);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    BTree<int> btree;
+    BPlusTree<int, int> bplus;
+    map<int, int> m;
+    for (int k : keys)
+    {
+        btree.insert(k);
+        bplus.insert(k, k);
+        m.emplace(k, k);
+    }
+
+    vector<int> starts(scans);
+    for (auto &st : starts)
+        st = static_cast<int>(gen() % static_cast<unsigned>(max(1, n - range_len)));
+
+    long long sink = 0;
+    size_t visited = 0;
+    perf_discard();
+
+    // полный упорядоченный обход
+    long long us = timed_us([&]
+                            {
+        for (auto it = btree.begin(); it != btree.end(); ++it)
+            sink += *it; });
+    double btree_full = n / (us / 1e6) / 1e6;
+
+    us = timed_us([&]
+                  {
+        for (auto it = bplus.begin(); !it.at_end(); ++it)
+            sink += it.value(); });
+    double bplus_full = n / (us / 1e6) / 1e6;
+
+    // короткие диапазоны
+    us = timed_us([&]
+                  {
+        for (int st : starts)
+            for (int k : btree.range(st, st + range_len - 1))
+            {
+                sink += k;
+                visited++;
+            } });
+    double btree_range = visited / (us / 1e6) / 1e6;
+
+    visited = 0;
+    us = timed_us([&]
+                  {
+        for (int st : starts)
+            for (auto it = bplus.range(st, st + range_len - 1); !it.at_end(); ++it)
+            {
+                sink += it.value();
+                visited++;
+            } });
+    double bplus_range = visited / (us / 1e6) / 1e6;
+
+    visited = 0;
+    us = timed_us([&]
+                  {
+        for (int st : starts)
+            for (auto it = m.lower_bound(st), e = m.upper_bound(st + range_len - 1); it != e; ++it)
+            {
+                sink += it->second;
+                visited++;
+            } });
+    double map_range = visited / (us / 1e6) / 1e6;
+
+    benchmark_sink = sink;
+
+    cout << fixed << setprecision(1);
+    cout << "Full scan   (Mkeys/s): BTree " << btree_full << ", BPlusTree " << bplus_full << "\n";
+    cout << "Range scans (Mkeys/s): BTree " << btree_range << ", BPlusTree " << bplus_range
+         << ", std::map " << map_range << "\n";
+
+    ofstream out("benchmark_range_scan.csv");
+    out << "n,range_len,btree_full_mkeys_s,bplus_full_mkeys_s,btree_range_mkeys_s,bplus_range_mkeys_s,map_range_mkeys_s"
+        << perf_csv_header() << "\n";
+    out << n << "," << range_len << "," << btree_full << "," << bplus_full << ","
+        << btree_range << "," << bplus_range << "," << map_range << perf_csv_fields() << "\n";
+}
+
+// ------------------------
+// BTree: поэлементная вставка vs bulk_load
+// ------------------------
+void run_bulk_load_benchmark()
+{
+    cout << "\n=========== BENCHMARK: BTree insert loop vs bulk_load ===========\n";
+
+    ofstream out("benchmark_bulk_load.csv");
+    out << "n,insert_loop_ms,bulk_load_ms" << perf_csv_header() << "\n";
+    for (int n : {100000, 1000000})
+    {
+        Sequence<int> data;
+        for (int i = 0; i < n; ++i)
+            data.push_back(i);
+        perf_discard();
+
+        BTree<int> a;
+        double loop_ms = timed_us([&]
+                                  {
+            for (int i = 0; i < n; ++i)
+                a.insert(data[i]); }) / 1000.0;
+
+        BTree<int> b;
+        double bulk_ms = timed_us([&]
+                                  { b.bulk_load(data); }) / 1000.0;
+
+        cout << fixed << setprecision(1) << "n=" << n << ": insert loop " << loop_ms
+             << " ms, bulk_load " << bulk_ms << " ms\n";
+        out << n << "," << loop_ms << "," << bulk_ms << perf_csv_fields() << "\n";
+    }
+}
+
+// ------------------------
+// BTree: плотность узлов и время построения
+// ------------------------
+void run_btree_node_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: BTree node density (n=" << n << ") ===========\n";
+
+    ofstream out("benchmark_btree_nodes.csv");
+    out << "n,build,build_ms,nodes,node_bytes,live_mb,reserved_mb,nodes_per_mb" << perf_csv_header() << "\n";
+
+    auto report = [&](const string &build, double ms, const BTree<int> &tree)
+    {
+        double live_mb = tree.memory_bytes() / 1048576.0;
+        double reserved_mb = tree.reserved_bytes() / 1048576.0;
+        double nodes_per_mb = tree.get_node_count() / reserved_mb;
+        cout << fixed << setprecision(1) << left << setw(12) << build << ms << " ms, "
+             << tree.get_node_count() << " nodes x " << BTree<int>::node_bytes() << " B, "
+             << reserved_mb << " MB, " << setprecision(0) << nodes_per_mb << " nodes/MB\n";
+        out << n << "," << build << "," << ms << "," << tree.get_node_count() << "," << BTree<int>::node_bytes()
+            << "," << live_mb << "," << reserved_mb << "," << nodes_per_mb << perf_csv_fields() << "\n";
+    };
+
+    {
+        BTree<int> tree;
+        perf_discard();
+        long long us = timed_us([&]
+                                {
+            for (int i = 0; i < n; ++i)
+                tree.insert(i); });
+        report("insert", us / 1000.0, tree);
+    }
+    {
+        Sequence<int> data;
+        for (int i = 0; i < n; ++i)
+            data.push_back(i);
+        BTree<int> tree;
+        perf_discard();
+        long long us = timed_us([&]
+                                { tree.bulk_load(data); });
+        report("bulk_load", us / 1000.0, tree);
+    }
+}
+
+// ------------------------
+// BTree: смешанная нагрузка insert/erase/search
+// ------------------------
+void run_btree_mixed_benchmark(int initial, int ops)
+{
+    cout << "\n=========== BENCHMARK: BTree mixed insert/erase/search ===========\n";
+
+    BTree<int> tree;
+    Sequence<int> data;
+    for (int i = 0; i < initial; ++i)
+        data.push_back(i * 2);
+    tree.bulk_load(data);
+
+    mt19937 gen(31337);
+    uniform_int_distribution<> key_dist(0, initial * 2);
+
+    ofstream out("benchmark_btree_mixed.csv");
+    out << "phase,ops_done,keys,nodes,memory_bytes,ops_per_sec" << perf_csv_header() << "\n";
+    cout << left << setw(10) << "phase" << setw(12) << "ops" << setw(12) << "keys"
+         << setw(12) << "nodes" << setw(16) << "memory" << "Mops/s\n";
+
+    auto report = [&](const string &phase, int done, double ops_per_sec)
+    {
+        cout << left << setw(10) << phase << setw(12) << done << setw(12) << tree.get_size()
+             << setw(12) << tree.get_node_count() << setw(16) << tree.memory_bytes()
+             << fixed << setprecision(2) << ops_per_sec / 1e6 << "\n";
+        out << phase << "," << done << "," << tree.get_size() << "," << tree.get_node_count() << ","
+            << tree.memory_bytes() << "," << ops_per_sec << perf_csv_fields() << "\n";
+    };
+
+    perf_discard();
+    report("start", 0, 0.0);
+
+    // 1/3 вставок, 1/3 удалений, 1/3 поиска
+    const int checkpoints = 4;
+    for (int c = 1; c <= checkpoints; ++c)
+    {
+        int chunk = ops / checkpoints;
+        long long us = timed_us([&]
+                                {
+            for (int i = 0; i < chunk; ++i)
+            {
+                int k = key_dist(gen);
+                switch (gen() % 3)
+                {
+                case 0:
+                    if (!tree.contains(k))
+                        tree.insert(k);
+                    break;
+                case 1:
+                    tree.erase(k);
+                    break;
+                default:
+                    tree.contains(k);
+                }
+            } });
+        report("mixed", c * chunk, chunk / (us / 1e6));
+    }
+
+    // удаление всех ключей — проверка возврата памяти
+    int erased = 0;
+    long long us = timed_us([&]
+                            {
+        for (int k = 0; k <= initial * 2; ++k)
+            erased += tree.erase(k) ? 1 : 0; });
+    report("drain", erased, erased / (us / 1e6));
+}
+
+// ------------------------
+// BTree<T> vs RecordIndex<T> для «тяжёлых» записей
+// ------------------------
+struct WideRecord
+{
+    int id;
+    char payload[252];
+
+    WideRecord() : id(0), payload() {}
+    explicit WideRecord(int id) : id(id), payload() {}
+
+    bool operator<(const WideRecord &other) const { return id < other.id; }
+    bool operator>(const WideRecord &other) const { return id > other.id; }
+    bool operator==(const WideRecord &other) const { return id == other.id; }
+};
+
+template <typename T, typename MakeFn>
+void compare_record_index(const string &label, int n, MakeFn make, ofstream &out)
+{
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+        keys[i] = i;
+    mt19937 gen(77);
+    shuffle(keys.begin(), keys.end(), gen);
+    vector<T> records;
+    records.reserve(n);
+    for (int k : keys)
+        records.push_back(make(k));
+
+    long long sink = 0;
+    perf_discard();
+
+    BTree<T> tree;
+    long long us = timed_us([&]
+                            {
+        for (const T &r : records)
+            tree.insert(r); });
+    double tree_ins = n / (us / 1e6);
+    us = timed_us([&]
+                  {
+        for (const T &r : records)
+            sink += RecordKey<T>::get(*tree.search(r)); });
+    double tree_find = n / (us / 1e6);
+
+    RecordIndex<T> idx;
+    us = timed_us([&]
+                  {
+        for (const T &r : records)
+            idx.insert(r); });
+    double idx_ins = n / (us / 1e6);
+    us = timed_us([&]
+                  {
+        for (const T &r : records)
+            sink += RecordKey<T>::get(*idx.search(RecordKey<T>::get(r))); });
+    double idx_find = n / (us / 1e6);
+
+    benchmark_sink = sink;
+
+    cout << fixed << setprecision(2) << left << setw(14) << label << setw(8) << sizeof(T)
+         << setw(14) << tree_ins / 1e6 << setw(14) << idx_ins / 1e6
+         << setw(14) << tree_find / 1e6 << setw(16) << idx_find / 1e6
+         << tree.memory_bytes() / 1048576.0 << " / " << (idx.index_memory_bytes() + idx.heap_memory_bytes()) / 1048576.0 << "\n";
+    out << label << "," << sizeof(T) << "," << n << "," << tree_ins << "," << idx_ins << ","
+        << tree_find << "," << idx_find << "," << tree.memory_bytes() << ","
+        << idx.index_memory_bytes() + idx.heap_memory_bytes() << perf_csv_fields() << "\n";
+}
+
+void run_record_index_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: BTree<T> vs RecordIndex<T> (n=" << n << ") ===========\n";
+    cout << left << setw(14) << "record" << setw(8) << "bytes"
+         << setw(14) << "tree ins M/s" << setw(14) << "index ins M/s"
+         << setw(14) << "tree find M/s" << setw(16) << "index find M/s" << "MB tree / index\n";
+
+    ofstream out("benchmark_record_index.csv");
+    out << "record,sizeof,n,btree_insert_ops,index_insert_ops,btree_find_ops,index_find_ops,btree_bytes,index_bytes"
+        << perf_csv_header() << "\n";
+
+    compare_record_index<int>("int", n, [](int k)
+                              { return k; }, out);
+    compare_record_index<Person>("Person", n, [](int k)
+                                 { return Person(k, "Person number " + to_string(k), 30, "person" + to_string(k) + "@example.com"); }, out);
+    compare_record_index<WideRecord>("WideRecord", n, [](int k)
+                                     { return WideRecord(k); }, out);
+}
+
+// ------------------------
+// Многопоточность: ConcurrentBTree (OLC) vs BTree под глобальным mutex
+// ------------------------
+template <typename OpFn>
+double run_threads(int threads, int ops_per_thread, OpFn op)
+{
+    // потоки создаются внутри участка и наследуют счётчики
+    PerfCounterScope perf;
+    vector<thread> pool;
+    long long t1 = us_now();
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t]
+                          {
+            mt19937 gen(1000 + t);
+            for (int i = 0; i < ops_per_thread; ++i)
+                op(gen); });
+    for (auto &th : pool)
+        th.join();
+    long long t2 = us_now();
+    return static_cast<double>(threads) * ops_per_thread / ((t2 - t1) / 1e6);
+}
+
+void run_concurrency_benchmark(int n, int ops_per_thread)
+{
+    cout << "\n=========== BENCHMARK: ConcurrentBTree vs BTree+mutex (n=" << n << ") ===========\n";
+
+    vector<int> thread_counts = {1, 2, 4};
+    int hw = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    for (int t = 8; t < hw; t *= 2)
+        thread_counts.push_back(t);
+    if (hw > 4)
+        thread_counts.push_back(hw);
+
+    ofstream out("benchmark_concurrency.csv");
+    out << "read_percent,threads,olc_mops,mutex_mops,olc_restarts" << perf_csv_header() << "\n";
+    cout << left << setw(10) << "read %" << setw(10) << "threads" << setw(14) << "OLC Mops/s"
+         << setw(14) << "mutex Mops/s" << "restarts\n";
+
+    for (int read_percent : {95, 50})
+    {
+        for (int threads : thread_counts)
+        {
+            ConcurrentBTree<int, int> olc;
+            BTree<int> locked;
+            mutex lock;
+            Sequence<int> data;
+            for (int i = 0; i < n; ++i)
+            {
+                olc.insert(i * 2, i);
+                data.push_back(i * 2);
+            }
+            locked.bulk_load(data);
+            perf_discard();
+
+            // чтения по существующим ключам, записи — новые нечётные ключи
+            double olc_ops = run_threads(threads, ops_per_thread, [&](mt19937 &gen)
+                                         {
+                int k = static_cast<int>(gen() % n);
+                int v;
+                if (static_cast<int>(gen() % 100) < read_percent)
+                    olc.find(k * 2, v);
+                else
+                    olc.insert(k * 2 + 1, k); });
+
+            double mutex_ops = run_threads(threads, ops_per_thread, [&](mt19937 &gen)
+                                           {
+                int k = static_cast<int>(gen() % n);
+                lock_guard<mutex> guard(lock);
+                if (static_cast<int>(gen() % 100) < read_percent)
+                    locked.contains(k * 2);
+                else if (!locked.contains(k * 2 + 1))
+                    locked.insert(k * 2 + 1); });
+
+            cout << fixed << setprecision(2) << left << setw(10) << read_percent << setw(10) << threads
+                 << setw(14) << olc_ops / 1e6 << setw(14) << mutex_ops / 1e6 << olc.get_restarts() << "\n";
+            out << read_percent << "," << threads << "," << olc_ops / 1e6 << "," << mutex_ops / 1e6 << ","
+                << olc.get_restarts() << perf_csv_fields() << "\n";
+        }
+    }
+}
+
+void run_concurrent_dictionary_benchmark(int n, int ops_per_thread)
+{
+    cout << "\n=========== BENCHMARK: ConcurrentDictionary vs Dictionary+mutex (n=" << n << ") ===========\n";
+
+    vector<int> thread_counts = {1, 2, 4};
+    int hw = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    for (int t = 8; t < hw; t *= 2)
+        thread_counts.push_back(t);
+    if (hw > 4)
+        thread_counts.push_back(hw);
+
+    ofstream out("benchmark_concurrent_dictionary.csv");
+    out << "read_percent,threads,striped_mops,mutex_mops,final_capacity" << perf_csv_header() << "\n";
+    cout << left << setw(10) << "read %" << setw(10) << "threads" << setw(16) << "striped Mops/s"
+         << setw(14) << "mutex Mops/s" << "capacity\n";
+
+    // 95% — таблица поиска, 20% — интенсивная запись
+    for (int read_percent : {95, 20})
+    {
+        for (int threads : thread_counts)
+        {
+            ConcurrentDictionary<int, int> striped;
+            Dictionary<int, int> locked;
+            mutex lock;
+            Sequence<int> keys;
+            keys.reserve(n);
+            for (int i = 0; i < n; ++i)
+            {
+                striped.insert(i, i);
+                keys.push_back(i);
+            }
+            locked.insert_bulk(keys, keys);
+            perf_discard();
+
+            // чтения по [0, n); записи вставляют и удаляют ключи из [n, 2n), размер держится около 1.5n
+            double striped_ops = run_threads(threads, ops_per_thread, [&](mt19937 &gen)
+                                             {
+                int k = static_cast<int>(gen() % n);
+                int v;
+                int roll = static_cast<int>(gen() % 100);
+                if (roll < read_percent)
+                    striped.find(k, v);
+                else if (roll % 2 == 0)
+                    striped.insert(n + k, k);
+                else
+                    striped.erase(n + k); });
+
+            double mutex_ops = run_threads(threads, ops_per_thread, [&](mt19937 &gen)
+                                           {
+                int k = static_cast<int>(gen() % n);
+                int roll = static_cast<int>(gen() % 100);
+                lock_guard<mutex> guard(lock);
+                if (roll < read_percent)
+                    locked.find(k);
+                else if (roll % 2 == 0)
+                    locked.insert(n + k, k);
+                else
+                    locked.erase(n + k); });
+
+            cout << fixed << setprecision(2) << left << setw(10) << read_percent << setw(10) << threads
+                 << setw(16) << striped_ops / 1e6 << setw(14) << mutex_ops / 1e6 << striped.get_capacity() << "\n";
+            out << read_percent << "," << threads << "," << striped_ops / 1e6 << "," << mutex_ops / 1e6 << ","
+                << striped.get_capacity() << perf_csv_fields() << "\n";
+        }
+    }
+}
+
+// ------------------------
+// EytzingerIndex vs BTree: задержка поиска на больших объёмах
+// ------------------------
+void run_eytzinger_benchmark(const vector<size_t> &sizes, int lookups)
+{
+    cout << "\n=========== BENCHMARK: EytzingerIndex vs BTree lookup ===========\n";
+
+    ofstream out("benchmark_eytzinger.csv");
+    out << "n,btree_ns,eytzinger_ns,binary_search_ns,btree_mb,eytzinger_mb" << perf_csv_header() << "\n";
+    cout << left << setw(12) << "n" << setw(12) << "BTree ns" << setw(14) << "Eytzinger ns" << setw(16) << "lower_bound ns"
+         << setw(12) << "BTree MB" << "Eytzinger MB\n";
+
+    mt19937 gen(99);
+    for (size_t n : sizes)
+    {
+        Sequence<int> data;
+        for (size_t i = 0; i < n; ++i)
+            data.push_back(static_cast<int>(i * 2));
+
+        vector<int> probes(lookups);
+        for (auto &p : probes)
+            p = static_cast<int>(gen() % n) * 2;
+
+        long long sink = 0;
+        double btree_ns, btree_mb;
+        {
+            BTree<int> tree;
+            tree.bulk_load(data);
+            perf_discard();
+            btree_ns = timed_us([&]
+                                {
+                for (int k : probes)
+                    sink += *tree.search(k); }) * 1000.0 / lookups;
+            btree_mb = tree.memory_bytes() / 1048576.0;
+        }
+
+        // обычный бинарный поиск по тому же отсортированному массиву — для сравнения с раскладкой
+        double bs_ns = timed_us([&]
+                                {
+            for (int k : probes)
+                sink += *lower_bound(data.begin(), data.end(), k); }) * 1000.0 / lookups;
+
+        EytzingerIndex<int> idx(data);
+        data.clear();
+        double eytz_ns = timed_us([&]
+                                  {
+            for (int k : probes)
+                sink += *idx.search(k); }) * 1000.0 / lookups;
+
+        double eytz_mb = idx.memory_bytes() / 1048576.0;
+        benchmark_sink = sink;
+
+        cout << fixed << setprecision(1) << left << setw(12) << n << setw(12) << btree_ns << setw(14) << eytz_ns
+             << setw(16) << bs_ns << setw(12) << btree_mb << eytz_mb << "\n";
+        out << n << "," << btree_ns << "," << eytz_ns << "," << bs_ns << "," << btree_mb << "," << eytz_mb
+            << perf_csv_fields() << "\n";
+    }
+}
+
+// ------------------------
+// SlowStorage: кэш под разными моделями задержки хранилища
+// ------------------------
+static double percentile(vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1));
+    nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+void run_slow_storage_benchmark(int n, int requests)
+{
+    cout << "\n=========== BENCHMARK: cache under simulated storage latency (n=" << n << ") ===========\n";
+
+    Sequence<int> data;
+    for (int i = 0; i < n; ++i)
+        data.push_back(i);
+
+    // 80% запросов в горячие 20% ключей
+    mt19937 gen(2024);
+    vector<int> pattern(requests);
+    for (auto &k : pattern)
+        k = (gen() % 100) < 80 ? static_cast<int>(gen() % (n / 5)) : static_cast<int>(gen() % n);
+
+    struct ModelCase
+    {
+        const char *name;
+        LatencyModel model;
+    };
+    vector<ModelCase> models = {
+        {"constant-20us", LatencyModel::constant(20.0)},
+        {"lognormal-20us-s0.8", LatencyModel::lognormal(20.0, 0.8)},
+        {"bimodal-10us/500us-2%", LatencyModel::bimodal(10.0, 500.0, 0.02)}};
+
+    ofstream out("benchmark_slow_storage.csv");
+    out << "model,mode,direct_ms,cache_ms,speedup,hit_rate,p50_us,p99_us" << perf_csv_header() << "\n";
+    cout << left << setw(24) << "model" << setw(8) << "mode" << setw(12) << "direct ms" << setw(12) << "cache ms"
+         << setw(10) << "speedup" << setw(10) << "p50 us" << "p99 us\n";
+
+    for (auto &mc : models)
+    {
+        for (WaitMode mode : {WaitMode::Spin, WaitMode::Sleep})
+        {
+            const char *mode_name = mode == WaitMode::Spin ? "spin" : "sleep";
+
+            SlowStorage<int> direct(mc.model, 1, mode);
+            direct.load(data);
+            vector<double> lat(requests);
+            perf_discard();
+            double direct_ms = timed_us([&]
+                                        {
+                for (int i = 0; i < requests; ++i)
+                {
+                    long long r1 = us_now();
+                    direct.contains(pattern[i]);
+                    lat[i] = static_cast<double>(us_now() - r1);
+                } }) / 1000.0;
+
+            CacheManager<int> cache(static_cast<size_t>(n / 10));
+            cache.set_storage_latency(mc.model, 1, mode);
+            cache.initialize(data);
+            double cache_ms = timed_us([&]
+                                       {
+                for (int k : pattern)
+                    cache.get(k); }) / 1000.0;
+
+            double speedup = cache_ms > 0 ? direct_ms / cache_ms : 0.0;
+
+            double p50 = percentile(lat, 50), p99 = percentile(lat, 99);
+            cout << fixed << setprecision(1) << left << setw(24) << mc.name << setw(8) << mode_name << setw(12) << direct_ms
+                 << setw(12) << cache_ms << setw(10) << speedup << setw(10) << p50 << p99 << "\n";
+            out << mc.name << "," << mode_name << "," << direct_ms << "," << cache_ms << "," << speedup << ","
+                << cache.get_statistics().hit_rate << "," << p50 << "," << p99 << perf_csv_fields() << "\n";
+        }
+    }
+
+    // ограниченная глубина очереди: 8 загрузчиков, sleep-режим
+    cout << "\nqueue depth vs 8 loader threads (constant 200us, sleep):\n";
+    ofstream qout("benchmark_storage_queue.csv");
+    qout << "queue_depth,threads,requests_per_sec,avg_queue_us" << perf_csv_header() << "\n";
+    cout << left << setw(10) << "depth" << setw(14) << "req/s" << "avg queue us\n";
+    for (size_t depth : {1, 2, 4, 8})
+    {
+        SlowStorage<int> shared(LatencyModel::constant(200.0), depth, WaitMode::Sleep);
+        shared.load(data);
+        perf_discard();
+        double rate = run_threads(8, 200, [&](mt19937 &g)
+                                  { shared.contains(static_cast<int>(g() % n)); });
+        SlowStorageStats st = shared.get_statistics();
+        cout << left << setw(10) << depth << setw(14) << static_cast<long long>(rate)
+             << st.total_queue_us / st.requests << "\n";
+        qout << depth << ",8," << rate << "," << st.total_queue_us / st.requests << perf_csv_fields() << "\n";
+    }
+}
+
+// ------------------------
+// PagedBTree: холодный старт и данные больше буферного пула
+// ------------------------
+void run_paged_btree_benchmark(int n, int lookups)
+{
+    cout << "\n=========== BENCHMARK: PagedBTree cold start & out-of-pool (n=" << n << ") ===========\n";
+
+    string path = (filesystem::temp_directory_path() / "paged_btree_bench.db").string();
+    filesystem::remove(path);
+
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+        keys[i] = i;
+    mt19937 gen(4242);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    long long t1 = us_now();
+    {
+        PagedBTree<CompactPerson> tree(path, 4096);
+        for (int k : keys)
+        {
+            CompactPerson p;
+            p.id = k;
+            p.age = k % 90;
+            tree.insert(k, p);
+        }
+        tree.flush();
+    }
+    long long t2 = us_now();
+    double build_ms = (t2 - t1) / 1000.0;
+
+    vector<int> probes(lookups);
+    for (auto &p : probes)
+        p = static_cast<int>(gen() % n);
+
+    // текущий путь старта: построить BTree в памяти и только потом отвечать
+    t1 = us_now();
+    Sequence<CompactPerson> data;
+    for (int i = 0; i < n; ++i)
+    {
+        CompactPerson p;
+        p.id = i;
+        p.age = i % 90;
+        data.push_back(p);
+    }
+    BTree<CompactPerson> mem_tree;
+    mem_tree.bulk_load(data);
+    long long rebuild_done = us_now();
+    long long sink = 0;
+    for (int k : probes)
+        sink += mem_tree.search(CompactPerson(k))->age;
+    t2 = us_now();
+    double rebuild_ms = (rebuild_done - t1) / 1000.0;
+    double mem_lookup_ms = (t2 - rebuild_done) / 1000.0;
+
+    ofstream out("benchmark_paged_btree.csv");
+    out << "pool_pages,pool_mb,file_pages,open_ms,lookup_ms,hit_rate,disk_reads" << perf_csv_header() << "\n";
+    cout << fixed << setprecision(1);
+    cout << "build file: " << build_ms << " ms; in-memory rebuild: " << rebuild_ms
+         << " ms + " << mem_lookup_ms << " ms for " << lookups << " lookups\n";
+    cout << left << setw(12) << "pool pages" << setw(10) << "pool MB" << setw(12) << "open ms"
+         << setw(14) << "lookups ms" << setw(12) << "hit %" << "disk reads\n";
+
+    // без сброса страничного кэша ОС "холодный" старт на самом деле тёплый
+    bool cold = true;
+    for (size_t pool_pages : {16, 64, 256, 1024, 4096})
+    {
+        cold = PageFile::drop_os_cache(path) && cold;
+        perf_discard();
+        PerfCounterScope perf;
+        t1 = us_now();
+        PagedBTree<CompactPerson> tree(path, pool_pages);
+        long long opened = us_now();
+        CompactPerson p;
+        for (int k : probes)
+            if (tree.find(k, p))
+                sink += p.age;
+        t2 = us_now();
+        perf.stop();
+
+        CacheStats st = tree.get_pool_statistics();
+        double pool_mb = pool_pages * BufferPool::PAGE_SIZE / 1048576.0;
+        cout << left << setw(12) << pool_pages << setw(10) << pool_mb << setw(12) << (opened - t1) / 1000.0
+             << setw(14) << (t2 - opened) / 1000.0 << setw(12) << st.hit_rate << tree.get_disk_reads() << "\n";
+        out << pool_pages << "," << pool_mb << "," << tree.get_page_count() << "," << (opened - t1) / 1000.0 << ","
+            << (t2 - opened) / 1000.0 << "," << st.hit_rate << "," << tree.get_disk_reads()
+            << perf_csv_fields() << "\n";
+    }
+    if (!cold)
+        cout << "note: OS page cache could not be dropped, open/lookup times are warm\n";
+    benchmark_sink = sink;
+    filesystem::remove(path);
+}
+
+// ------------------------
+// Person vs CompactPerson: байт на запись
+// ------------------------
+static size_t string_heap_bytes(const std::string &s)
+{
+    // строки короче SSO-буфера не аллоцируют память
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+Sequence<Person> make_person_dataset(int n)
+{
+    static const char *names[] = {"Anna", "Ivan", "Maria", "Alexander", "Elena", "Dmitry",
+                                  "Olga", "Sergey", "Natalia", "Konstantin", "Tatiana", "Mikhail"};
+    static const char *domains[] = {"gmail.com", "yandex.ru", "mail.ru", "outlook.com", "company-internal.org"};
+
+    Sequence<Person> people;
+    for (int i = 0; i < n; ++i)
+    {
+        string name = names[i % 12];
+        string email = "user" + to_string(i) + "@" + domains[(i * 7) % 5];
+        people.push_back(Person(i, name, 18 + i % 60, email));
+    }
+    return people;
+}
+
+// ------------------------
+// Sequence: число выделений памяти при росте и вставке
+// ------------------------
+void run_sequence_allocation_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: Sequence allocations (n=" << n << ") ===========\n";
+
+    Sequence<Person> people = make_person_dataset(n);
+
+    ofstream out("benchmark_sequence_alloc.csv");
+    out << "case,allocations,ms" << perf_csv_header() << "\n";
+    cout << left << setw(36) << "case" << setw(14) << "allocations" << "ms\n";
+
+    auto report = [&](const string &name, size_t allocs, long long us)
+    {
+        cout << left << setw(36) << name << setw(14) << allocs << fixed << setprecision(1) << us / 1000.0 << "\n";
+        out << name << "," << allocs << "," << us / 1000.0 << perf_csv_fields() << "\n";
+    };
+    perf_discard();
+
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Person> copy;
+        for (size_t i = 0; i < people.get_size(); ++i)
+            copy.push_back(people[i]);
+        perf.stop();
+        report("Sequence<Person> push_back(copy)", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        Sequence<Person> source = people;
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Person> moved;
+        for (size_t i = 0; i < source.get_size(); ++i)
+            moved.push_back(std::move(source[i]));
+        perf.stop();
+        report("Sequence<Person> push_back(move)", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        Sequence<Person> source = people;
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Person> reserved;
+        reserved.reserve(source.get_size());
+        for (size_t i = 0; i < source.get_size(); ++i)
+            reserved.emplace_back(std::move(source[i]));
+        perf.stop();
+        report("Sequence<Person> reserve+emplace", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Person> built = make_person_dataset(n);
+        perf.stop();
+        report("make_person_dataset", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, int> dict;
+        for (int i = 0; i < n; ++i)
+            dict.insert(i, i);
+        perf.stop();
+        report("Dictionary<int,int> insert", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        Sequence<int> keys;
+        keys.reserve(n);
+        for (int i = 0; i < n; ++i)
+            keys.push_back(i);
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, int> dict;
+        dict.insert_bulk(keys, keys);
+        perf.stop();
+        report("Dictionary<int,int> insert_bulk", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        CacheManager<Person> cache(1000);
+        cache.initialize(people);
+        perf.stop();
+        report("CacheManager<Person> initialize", allocations_now() - a1, us_now() - t1);
+    }
+}
+
+// ------------------------
+// SegmentedSequence vs Sequence: дозапись и пиковая память
+// ------------------------
+template <typename Seq>
+void measure_append(const string &name, size_t n, ofstream &out)
+{
+    reset_peak_rss();
+    size_t base = current_rss_bytes();
+    perf_discard();
+    long long us = timed_us([&]
+                            {
+        Seq s;
+        for (size_t i = 0; i < n; ++i)
+            s.push_back(static_cast<int>(i));
+        benchmark_sink = s[n - 1]; });
+    size_t peak = peak_rss_bytes();
+    double peak_mb = peak > base ? (peak - base) / 1048576.0 : 0.0;
+    double mops = n / (us / 1e6) / 1e6;
+
+    cout << left << setw(28) << name << setw(12) << n << fixed << setprecision(1) << setw(14) << mops << peak_mb << "\n";
+    out << name << "," << n << "," << mops << "," << peak_mb << perf_csv_fields() << "\n";
+}
+
+void run_segmented_sequence_benchmark(size_t n)
+{
+    cout << "\n=========== BENCHMARK: append, Sequence vs SegmentedSequence ===========\n";
+    cout << "payload: " << n * sizeof(int) / 1048576.0 << " MB\n";
+
+    ofstream out("benchmark_segmented.csv");
+    out << "container,n,append_mops,peak_rss_mb" << perf_csv_header() << "\n";
+    cout << left << setw(28) << "container" << setw(12) << "n" << setw(14) << "Mappend/s" << "peak RSS MB\n";
+
+    measure_append<Sequence<int>>("Sequence<int>", n, out);
+    measure_append<SegmentedSequence<int>>("SegmentedSequence<int>", n, out);
+    measure_append<SegmentedSequence<int, 65536>>("SegmentedSequence<int,64K>", n, out);
+}
+
+// ------------------------
+// MappedSequence: CacheManager поверх файла без копирования
+// ------------------------
+void run_mapped_sequence_benchmark(int n, int lookups)
+{
+    cout << "\n=========== BENCHMARK: CacheManager in-memory vs mapped file (n=" << n << ") ===========\n";
+
+    string path = (filesystem::temp_directory_path() / "mapped_records_bench.bin").string();
+    {
+        Sequence<CompactPerson> records;
+        records.reserve(n);
+        for (int i = 0; i < n; ++i)
+        {
+            CompactPerson p(i);
+            p.age = i % 90;
+            records.push_back(p);
+        }
+        MappedSequence<CompactPerson>::write_file(path, records);
+    }
+
+    mt19937 gen(31);
+    vector<int> probes(lookups);
+    for (auto &k : probes)
+        k = static_cast<int>(gen() % n);
+
+    ofstream out("benchmark_mapped.csv");
+    out << "mode,init_ms,init_peak_rss_mb,lookup_ms,hit_rate" << perf_csv_header() << "\n";
+    cout << left << setw(12) << "mode" << setw(12) << "init ms" << setw(16) << "init peak MB" << setw(12) << "lookup ms"
+         << "hit %\n";
+
+    for (bool use_mapping : {false, true})
+    {
+        // in-memory режим: данные читаются из файла в Sequence, как у вызывающего кода сейчас
+        Sequence<CompactPerson> caller_copy;
+        if (!use_mapping)
+        {
+            MappedSequence<CompactPerson> file(path);
+            caller_copy.reserve(file.get_size());
+            for (const CompactPerson &p : file)
+                caller_copy.push_back(p);
+        }
+
+        CacheManager<CompactPerson> cache(10000);
+        reset_peak_rss();
+        size_t base = current_rss_bytes();
+        perf_discard();
+        PerfCounterScope init_perf;
+        long long t1 = us_now();
+        if (use_mapping)
+            cache.initialize_mapped(path);
+        else
+            cache.initialize(caller_copy);
+        long long t2 = us_now();
+        init_perf.stop();
+        size_t peak = peak_rss_bytes();
+        double init_ms = (t2 - t1) / 1000.0;
+        double peak_mb = peak > base ? (peak - base) / 1048576.0 : 0.0;
+
+        long long sink = 0;
+        PerfCounterScope lookup_perf;
+        t1 = us_now();
+        for (int k : probes)
+            sink += cache.get(k)->age;
+        t2 = us_now();
+        lookup_perf.stop();
+        benchmark_sink = sink;
+
+        const char *mode = use_mapping ? "mapped" : "in-memory";
+        double hit_rate = cache.get_statistics().hit_rate;
+        cout << fixed << setprecision(1) << left << setw(12) << mode << setw(12) << init_ms << setw(16) << peak_mb
+             << setw(12) << (t2 - t1) / 1000.0 << hit_rate << "\n";
+        out << mode << "," << init_ms << "," << peak_mb << "," << (t2 - t1) / 1000.0 << "," << hit_rate
+            << perf_csv_fields() << "\n";
+    }
+    filesystem::remove(path);
+}
+
+// ------------------------
+// Параллельные алгоритмы: масштабирование по числу потоков
+// ------------------------
+void run_parallel_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: parallel algorithms on Sequence<Person> (n=" << n << ") ===========\n";
+
+    Sequence<Person> people = make_person_dataset(n);
+    mt19937 gen(77);
+    for (auto &p : people)
+        p.age = static_cast<int>(gen() % 100);
+
+    auto by_age = [](const Person &a, const Person &b)
+    { return a.age != b.age ? a.age < b.age : a.id < b.id; };
+
+    // последовательные версии — базовая линия
+    double serial_ms[5];
+    string serial_perf[5];
+    {
+        Sequence<Person> copy = people;
+        Sequence<size_t> lengths;
+        long long total = 0;
+        int found = -1;
+        perf_discard();
+        serial_ms[0] = timed_us([&]
+                                { sort(copy.begin(), copy.end(), by_age); }) / 1000.0;
+        serial_perf[0] = perf_csv_fields();
+
+        serial_ms[1] = timed_us([&]
+                                {
+            for (auto &p : copy)
+                p.age = p.age * 3 % 100; }) / 1000.0;
+        serial_perf[1] = perf_csv_fields();
 
-using namespace std;
+        serial_ms[2] = timed_us([&]
+                                {
+            for (const auto &p : people)
+                lengths.push_back(p.email.size()); }) / 1000.0;
+        serial_perf[2] = perf_csv_fields();
 
-// Таймер
-long long ms_now()
+        serial_ms[3] = timed_us([&]
+                                {
+            for (const auto &p : people)
+                total += p.age; }) / 1000.0;
+        serial_perf[3] = perf_csv_fields();
+
+        serial_ms[4] = timed_us([&]
+                                {
+            for (size_t i = 0; i < people.get_size() && found < 0; ++i)
+                if (people[i].email == "missing@nowhere")
+                    found = static_cast<int>(i); }) / 1000.0;
+        serial_perf[4] = perf_csv_fields();
+        benchmark_sink = total + found + static_cast<long long>(lengths.get_size());
+    }
+
+    const char *names[5] = {"sort", "for_each", "transform", "reduce", "find_if"};
+    ofstream out("benchmark_parallel.csv");
+    out << "algorithm,threads,ms,speedup_vs_serial" << perf_csv_header() << "\n";
+    for (int a = 0; a < 5; ++a)
+        out << names[a] << ",serial," << serial_ms[a] << ",1" << serial_perf[a] << "\n";
+
+    cout << "hardware threads: " << thread::hardware_concurrency() << "\n";
+    cout << left << setw(12) << "threads";
+    for (const char *name : names)
+        cout << setw(14) << name;
+    cout << "\n" << left << setw(12) << "serial";
+    for (double ms : serial_ms)
+        cout << fixed << setprecision(1) << setw(14) << ms;
+    cout << "\n";
+
+    vector<size_t> thread_counts = {1, 2, 4};
+    size_t hw = max(1u, thread::hardware_concurrency());
+    for (size_t t = 8; t <= hw; t *= 2)
+        thread_counts.push_back(t);
+
+    for (size_t threads : thread_counts)
+    {
+        // пул из threads-1 рабочих: вызывающий поток тоже выполняет задачи;
+        // он создаётся после PerfCounters::enable(), так что рабочие наследуют счётчики
+        ThreadPool pool(threads > 1 ? threads - 1 : 1);
+        double ms[5];
+        string perf[5];
+        Sequence<Person> copy = people;
+        Sequence<size_t> lengths;
+        long long total = 0;
+        int found = -1;
+        perf_discard();
+
+        ms[0] = timed_us([&]
+                         { parallel_sort(copy, by_age, pool); }) / 1000.0;
+        perf[0] = perf_csv_fields();
+
+        ms[1] = timed_us([&]
+                         {
+            parallel_for_each(copy, [](Person &p)
+                              { p.age = p.age * 3 % 100; }, pool); }) / 1000.0;
+        perf[1] = perf_csv_fields();
+
+        ms[2] = timed_us([&]
+                         {
+            lengths = parallel_transform(people, [](const Person &p)
+                                         { return p.email.size(); }, pool); }) / 1000.0;
+        perf[2] = perf_csv_fields();
+
+        ms[3] = timed_us([&]
+                         {
+            total = parallel_transform_reduce(
+                people, 0LL, [](long long x, long long y)
+                { return x + y; },
+                [](const Person &p)
+                { return static_cast<long long>(p.age); },
+                pool); }) / 1000.0;
+        perf[3] = perf_csv_fields();
+
+        ms[4] = timed_us([&]
+                         {
+            found = parallel_find_if(people, [](const Person &p)
+                                     { return p.email == "missing@nowhere"; }, pool); }) / 1000.0;
+        perf[4] = perf_csv_fields();
+        benchmark_sink = total + found + static_cast<long long>(lengths.get_size());
+
+        cout << left << setw(12) << threads;
+        for (int a = 0; a < 5; ++a)
+        {
+            cout << setw(14) << ms[a];
+            out << names[a] << "," << threads << "," << ms[a] << "," << (ms[a] > 0 ? serial_ms[a] / ms[a] : 0.0)
+                << perf[a] << "\n";
+        }
+        cout << "\n";
+    }
+}
+
+// ------------------------
+// SIMD-поиск: скалярный цикл против SSE2 / AVX2
+// ------------------------
+template <typename T>
+static void simd_search_case(const char *type, size_t n, size_t total_elements, ofstream &out)
 {
-    return chrono::duration_cast<chrono::milliseconds>(
-               chrono::steady_clock::now().time_since_epoch())
-        .count();
+    mt19937 gen(static_cast<unsigned>(n));
+    Sequence<T> data;
+    data.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        data.push_back(static_cast<T>(static_cast<int>(gen() % 1000000)));
+    Sequence<T> keys;
+    for (int k : {-1, -2, -3, -4})
+        keys.push_back(static_cast<T>(k)); // отсутствуют: bitmap проходит все ключи
+
+    // одинаковый объём работы для всех n: много проходов по маленькому массиву
+    size_t reps = max<size_t>(1, total_elements / n);
+    const char *ops[5] = {"find_miss", "count", "min", "max", "bitmap4"};
+    double scalar_ns[5] = {0, 0, 0, 0, 0};
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        SimdSearch::set_level(level);
+        if (SimdSearch::level() != level)
+            continue; // процессор не умеет
+
+        for (int op = 0; op < 5; ++op)
+        {
+            long long sink = 0;
+            perf_discard();
+            PerfCounterScope perf;
+            long long t1 = us_now();
+            for (size_t r = 0; r < reps; ++r)
+            {
+                switch (op)
+                {
+                case 0:
+                    sink += data.find(static_cast<T>(-7));
+                    break;
+                case 1:
+                    sink += static_cast<long long>(data.count(data[r % n]));
+                    break;
+                case 2:
+                    sink += static_cast<long long>(data.min_value());
+                    break;
+                case 3:
+                    sink += static_cast<long long>(data.max_value());
+                    break;
+                default:
+                    sink += static_cast<long long>(data.membership_bitmap(keys)[0]);
+                    break;
+                }
+            }
+            double ns = (us_now() - t1) * 1000.0 / (static_cast<double>(reps) * n);
+            perf.stop();
+            benchmark_sink = sink;
+            if (level == SimdLevel::Scalar)
+                scalar_ns[op] = ns;
+            double speedup = ns > 0 ? scalar_ns[op] / ns : 0.0;
+
+            cout << left << setw(8) << type << setw(12) << n << setw(10) << SimdSearch::level_name(level)
+                 << setw(12) << ops[op] << fixed << setprecision(3) << setw(14) << ns
+                 << setprecision(2) << speedup << "x\n";
+            out << type << "," << n << "," << SimdSearch::level_name(level) << "," << ops[op] << ","
+                << ns << "," << speedup << perf_csv_fields() << "\n";
+        }
+    }
+    SimdSearch::set_level(SimdSearch::detected_level());
+}
+
+void run_simd_search_benchmark(size_t total_elements)
+{
+    cout << "\n=========== BENCHMARK: SIMD search kernels (detected: "
+         << SimdSearch::level_name(SimdSearch::detected_level()) << ") ===========\n";
+    cout << left << setw(8) << "type" << setw(12) << "n" << setw(10) << "level"
+         << setw(12) << "op" << setw(14) << "ns/element" << "speedup\n";
+
+    ofstream out("benchmark_simd.csv");
+    out << "type,n,level,op,ns_per_element,speedup_vs_scalar" << perf_csv_header() << "\n";
+
+    // L1, L2 и память; массивы больше общего объёма работы не строим
+    for (size_t n : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 24})
+    {
+        if (n > total_elements)
+            break;
+        simd_search_case<int>("int", n, total_elements, out);
+        simd_search_case<float>("float", n, total_elements, out);
+    }
+}
+
+// ------------------------
+// Dictionary: итерация без копий и пакетные операции
+// ------------------------
+template <typename V>
+static void dictionary_bulk_case(const string &type, const Sequence<int> &keys, const Sequence<V> &values, ofstream &out)
+{
+    int n = static_cast<int>(keys.get_size());
+    auto report = [&](const string &name, size_t allocs, long long us)
+    {
+        cout << left << setw(28) << type << setw(26) << name << setw(14) << allocs << fixed << setprecision(1)
+             << us / 1000.0 << "\n";
+        out << type << "," << name << "," << allocs << "," << us / 1000.0 << perf_csv_fields() << "\n";
+    };
+    perf_discard();
+
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, V> dict;
+        for (int i = 0; i < n; ++i)
+            dict.insert(keys[i], values[i]);
+        perf.stop();
+        report("insert loop", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, V> dict;
+        dict.reserve(n);
+        for (int i = 0; i < n; ++i)
+            dict.insert(keys[i], values[i]);
+        perf.stop();
+        report("reserve + insert", allocations_now() - a1, us_now() - t1);
+    }
+
+    Dictionary<int, V> dict;
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        dict.insert_bulk(keys, values);
+        perf.stop();
+        report("insert_bulk", allocations_now() - a1, us_now() - t1);
+    }
+
+    // экспорт: раньше единственный способ обойти словарь
+    long long sink = 0;
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Pair<int, V>> all = dict.get_all_entries();
+        for (const auto &e : all)
+            sink += e.key;
+        perf.stop();
+        report("export get_all_entries", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        for (const auto &e : dict)
+            sink += e.key;
+        perf.stop();
+        report("export iterator", allocations_now() - a1, us_now() - t1);
+    }
+    benchmark_sink = sink;
+
+    // удаление каждого третьего: через копию и erase по ключу против erase_if
+    {
+        Dictionary<int, V> copy;
+        copy.insert_bulk(keys, values);
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Sequence<Pair<int, V>> all = copy.get_all_entries();
+        for (const auto &e : all)
+            if (e.key % 3 == 0)
+                copy.erase(e.key);
+        perf.stop();
+        report("copy + erase", allocations_now() - a1, us_now() - t1);
+    }
+    {
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        dict.erase_if([](const Pair<int, V> &e)
+                      { return e.key % 3 == 0; });
+        perf.stop();
+        report("erase_if", allocations_now() - a1, us_now() - t1);
+    }
+}
+
+void run_dictionary_bulk_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: Dictionary bulk operations (n=" << n << ") ===========\n";
+    cout << left << setw(28) << "dictionary" << setw(26) << "operation" << setw(14) << "allocations" << "ms\n";
+
+    ofstream out("benchmark_dictionary_bulk.csv");
+    out << "dictionary,operation,allocations,ms" << perf_csv_header() << "\n";
+
+    Sequence<int> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i)
+        keys.push_back(i);
+    dictionary_bulk_case<int>("Dictionary<int,int>", keys, keys, out);
+
+    int people_n = n / 5;
+    Sequence<int> person_keys;
+    person_keys.reserve(people_n);
+    for (int i = 0; i < people_n; ++i)
+        person_keys.push_back(i);
+    dictionary_bulk_case<Person>("Dictionary<int,Person>", person_keys, make_person_dataset(people_n), out);
 }
 
 // ------------------------
-// Оценка памяти
+// SmallSequence: маленькие контейнеры без кучи
 // ------------------------
-size_t estimate_memory_dictionary(size_t entries)
+void run_small_sequence_benchmark(int n)
 {
-    // приблизительная модель:
-    //   Pair(K,V) ≈ 16–24 bytes (ключ + значение + выравнивание)
-    //   указатели списков, bucket array etc
-    //   грубо: 48 bytes на элемент
-    return entries * 48;
+    cout << "\n=========== BENCHMARK: small containers (n=" << n << ") ===========\n";
+
+    ofstream out("benchmark_small_sequence.csv");
+    out << "case,allocations,rss_mb,ms" << perf_csv_header() << "\n";
+    cout << left << setw(40) << "case" << setw(14) << "allocations" << setw(10) << "RSS MB" << "ms\n";
+
+    auto report = [&](const string &name, size_t allocs, size_t rss, long long us)
+    {
+        double mb = rss / 1048576.0;
+        cout << left << setw(40) << name << setw(14) << allocs << fixed << setprecision(1) << setw(10) << mb
+             << us / 1000.0 << "\n";
+        out << name << "," << allocs << "," << mb << "," << us / 1000.0 << perf_csv_fields() << "\n";
+    };
+    perf_discard();
+
+    {
+        size_t r1 = current_rss_bytes();
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, int> dict;
+        for (int i = 0; i < n; ++i)
+            dict.insert(i, i);
+        long long t2 = us_now();
+        perf.stop();
+        size_t r2 = current_rss_bytes();
+        report("Dictionary<int,int> insert", allocations_now() - a1, r2 > r1 ? r2 - r1 : 0, t2 - t1);
+    }
+    {
+        size_t r1 = current_rss_bytes();
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        Dictionary<int, CompactPerson> dict;
+        for (int i = 0; i < n; ++i)
+            dict.insert(i, CompactPerson(i));
+        long long t2 = us_now();
+        perf.stop();
+        size_t r2 = current_rss_bytes();
+        report("Dictionary<int,CompactPerson> insert", allocations_now() - a1, r2 > r1 ? r2 - r1 : 0, t2 - t1);
+    }
+    {
+        Sequence<int> data;
+        for (int i = 0; i < 1000; ++i)
+            data.push_back(i);
+        CacheManager<int> cache(10);
+        cache.initialize(data);
+        PerfCounterScope perf;
+        size_t a1 = allocations_now();
+        long long t1 = us_now();
+        long long sink = 0;
+        for (int i = 0; i < n; ++i)
+            sink += cache.get_cache_keys().get_size();
+        long long t2 = us_now();
+        perf.stop();
+        benchmark_sink = sink;
+        report("get_cache_keys() x n, 10 keys", allocations_now() - a1, 0, t2 - t1);
+    }
 }
 
-size_t estimate_memory_btree(size_t entries)
+void run_person_encoding_benchmark(int n)
 {
-    // в BTree каждый узел содержит до ORDER-1 ключей и ORDER детей
-    // ORDER=4, значит 3 ключа, 4 указателя
-    // Эмпирическая модель: ~64 bytes на запись
-    return entries * 64;
+    cout << "\n=========== BENCHMARK: Person vs CompactPerson (n=" << n << ") ===========\n";
+
+    Sequence<Person> people = make_person_dataset(n);
+
+    size_t person_bytes = 0;
+    for (size_t i = 0; i < people.get_size(); ++i)
+        person_bytes += sizeof(Person) + string_heap_bytes(people[i].name) + string_heap_bytes(people[i].email);
+
+    StringPool pool;
+    Sequence<CompactPerson> compact;
+    perf_discard();
+    {
+        // perf_* в CSV относятся к кодированию записей
+        PerfCounterScope perf;
+        for (size_t i = 0; i < people.get_size(); ++i)
+            compact.push_back(CompactPerson(people[i], pool));
+    }
+    size_t compact_bytes = compact.get_size() * sizeof(CompactPerson);
+
+    // all_data, узлы BTree и cache_map держат по копии записи, пул строк — один
+    double before = static_cast<double>(person_bytes) / n;
+    double after_record = static_cast<double>(compact_bytes) / n;
+    double after_pool = static_cast<double>(pool.bytes_used()) / n;
+
+    cout << fixed << setprecision(1);
+    cout << "Person:        " << before << " bytes/entry (x3 copies = " << 3 * before << ")\n";
+    cout << "CompactPerson: " << after_record << " bytes/entry + pool " << after_pool
+         << " (x3 copies = " << 3 * after_record + after_pool << ")\n";
+    cout << "Interned strings: " << pool.get_size() << "\n";
+
+    ofstream out("benchmark_person_encoding.csv");
+    out << "n,person_bytes_per_entry,compact_bytes_per_entry,pool_bytes_per_entry,interned_strings" << perf_csv_header()
+        << "\n";
+    out << n << "," << before << "," << after_record << "," << after_pool << "," << pool.get_size() << perf_csv_fields()
+        << "\n";
 }
 
 // ------------------------
-// Бенчмарк для Dictionary и BTree
+// Кэш из нескольких потоков: пропускная способность и задержки по потокам
 // ------------------------
-struct BenchResult
+
+// Закрепить текущий поток за ядром; false, если ОС не поддерживает или отказала
+static bool pin_current_thread(int cpu)
 {
-    int n;
-    long long insert_dict_ms;
-    long long search_dict_ms;
-    long long insert_tree_ms;
-    long long search_tree_ms;
-    size_t mem_dict;
-    size_t mem_tree;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// CacheManager за одним мьютексом — так кэш разделяют потоки сейчас
+struct LockedCache
+{
+    CacheManager<int> cache;
+    mutex lock;
+
+    LockedCache(size_t capacity, const Sequence<int> &data) : cache(capacity) { cache.initialize(data); }
+
+    int get(int key)
+    {
+        lock_guard<mutex> guard(lock);
+        const int *v = cache.get(key);
+        return v ? *v : -1;
+    }
+
+    void put(int key, int value)
+    {
+        lock_guard<mutex> guard(lock);
+        cache.put(key, value);
+    }
+
+    CacheStats statistics()
+    {
+        lock_guard<mutex> guard(lock);
+        return cache.get_statistics();
+    }
+
+    double hit_rate() { return statistics().hit_rate; }
 };
 
-BenchResult run_single(int n)
+// Тот же объём, разрезанный на независимые части по хешу ключа.
+// Каждый шард хранит только свои записи: ключ key лежит в шарде shard_of(key)
+// на позиции slot[key], и предзагрузка шарда берёт только его собственные ключи.
+struct ShardedCache
 {
-    BenchResult r;
-    r.n = n;
+    vector<unique_ptr<LockedCache>> shards;
+    vector<int> slot; // ключ -> позиция в данных своего шарда
+
+    size_t shard_of(int key) const
+    {
+        uint32_t h = static_cast<uint32_t>(key) * 0x9E3779B1u;
+        return (h >> 16) % shards.size();
+    }
+
+    ShardedCache(size_t shard_count, size_t capacity, const Sequence<int> &data) : shards(shard_count)
+    {
+        vector<Sequence<int>> parts(shard_count);
+        slot.resize(data.get_size());
+        for (size_t key = 0; key < data.get_size(); ++key)
+        {
+            Sequence<int> &part = parts[shard_of(static_cast<int>(key))];
+            slot[key] = static_cast<int>(part.get_size());
+            part.push_back(data[key]);
+        }
+        for (size_t i = 0; i < shard_count; ++i)
+            shards[i].reset(new LockedCache(max<size_t>(1, capacity / shard_count), parts[i]));
+    }
+
+    int get(int key)
+    {
+        if (key < 0 || static_cast<size_t>(key) >= slot.size())
+            return -1;
+        return shards[shard_of(key)]->get(slot[key]);
+    }
+
+    void put(int key, int value)
+    {
+        if (key >= 0 && static_cast<size_t>(key) < slot.size())
+            shards[shard_of(key)]->put(slot[key], value);
+    }
+
+    // доля попаданий по всем обращениям, а не среднее по шардам: горячие шарды весят больше
+    double hit_rate()
+    {
+        size_t hits = 0, accesses = 0;
+        for (auto &s : shards)
+        {
+            CacheStats st = s->statistics();
+            hits += st.hits;
+            accesses += st.total_accesses;
+        }
+        return accesses > 0 ? (100.0 * hits) / accesses : 0.0;
+    }
+};
+
+struct ThreadLatency
+{
+    double p50_ns, p90_ns, p99_ns, p999_ns, max_ns;
+};
+
+struct CacheLoadResult
+{
+    double ops_per_sec;
+    double hit_rate;
+    bool pinned;
+    ThreadLatency all;             // все операции всех потоков
+    vector<ThreadLatency> threads; // по каждому потоку
+};
+
+static ThreadLatency summarize_latency(const vector<double> &ns)
+{
+    return {percentile(ns, 50), percentile(ns, 90), percentile(ns, 99), percentile(ns, 99.9),
+            ns.empty() ? 0.0 : *max_element(ns.begin(), ns.end())};
+}
 
+/**
+ * Ключи (Workload) и решения чтение/запись готовятся заранее, каждый поток
+ * получает свой отрезок, ждёт общего старта и замеряет каждую операцию.
+ * ops/s — все операции за время от старта до завершения последнего потока.
+ */
+template <typename Cache>
+static CacheLoadResult drive_cache(Cache &cache, int n, const string &workload, int read_percent, int threads,
+                                   int ops_per_thread, bool pin, uint32_t seed)
+{
+    // один общий поток запросов, нарезанный на потоки: горячие ключи у всех одни и те же
+    size_t total = static_cast<size_t>(threads) * ops_per_thread;
+    Workload w(n, seed);
+    if (workload == "uniform")
+        w.uniform(total);
+    else
+        w.zipf(total, 0.99);
+    const Sequence<int> &keys = w.keys();
+    vector<char> writes(total);
+    mt19937 gen(seed);
+    for (char &wr : writes)
+        wr = static_cast<int>(gen() % 100) >= read_percent;
+
+    int hw = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    vector<vector<double>> latency(threads, vector<double>(ops_per_thread));
+    atomic<int> ready{0};
+    atomic<bool> go{false};
+    atomic<int> pinned{0};
+    vector<long long> finished(threads);
+    vector<thread> pool;
+
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t]
+                          {
+            if (pin && pin_current_thread(t % hw))
+                pinned.fetch_add(1);
+            const int *k = keys.begin() + static_cast<size_t>(t) * ops_per_thread;
+            const char *wr = writes.data() + static_cast<size_t>(t) * ops_per_thread;
+            vector<double> &lat = latency[t];
+            long long sink = 0;
+            ready.fetch_add(1);
+            while (!go.load(memory_order_acquire))
+                this_thread::yield();
+            for (int i = 0; i < ops_per_thread; ++i)
+            {
+                auto t1 = chrono::steady_clock::now();
+                if (wr[i])
+                    cache.put(k[i], i);
+                else
+                    sink += cache.get(k[i]);
+                auto t2 = chrono::steady_clock::now();
+                lat[i] = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count());
+            }
+            finished[t] = us_now();
+            benchmark_sink += sink; });
+
+    while (ready.load() < threads)
+        this_thread::yield();
+    long long start = us_now();
+    {
+        // потоки созданы после PerfCounters::enable(), их события тоже попадают в счётчики
+        PerfCounterScope perf;
+        go.store(true, memory_order_release);
+        for (auto &th : pool)
+            th.join();
+    }
+    long long end = *max_element(finished.begin(), finished.end());
+
+    CacheLoadResult r;
+    r.ops_per_sec = static_cast<double>(threads) * ops_per_thread / (max(1LL, end - start) / 1e6);
+    r.hit_rate = cache.hit_rate();
+    r.pinned = pin && pinned.load() == threads;
+    vector<double> all;
+    all.reserve(static_cast<size_t>(threads) * ops_per_thread);
+    for (auto &lat : latency)
+    {
+        r.threads.push_back(summarize_latency(lat));
+        all.insert(all.end(), lat.begin(), lat.end());
+    }
+    r.all = summarize_latency(all);
+    return r;
+}
+
+static CacheLoadResult run_cache_load(const string &subject, int n, const string &workload, int read_percent,
+                                      int threads, int ops_per_thread, bool pin, uint32_t seed)
+{
     Sequence<int> data;
+    data.reserve(n);
+    for (int i = 0; i < n; ++i)
+        data.push_back(i);
+    size_t capacity = static_cast<size_t>(max(1, n / 10));
+
+    if (subject == "sharded-16")
+    {
+        ShardedCache cache(16, capacity, data);
+        return drive_cache(cache, n, workload, read_percent, threads, ops_per_thread, pin, seed);
+    }
+    LockedCache cache(capacity, data);
+    return drive_cache(cache, n, workload, read_percent, threads, ops_per_thread, pin, seed);
+}
+
+void run_cache_threads_benchmark(int n, int ops_per_thread, bool pin_threads)
+{
+    cout << "\n=========== BENCHMARK: cache from many threads (n=" << n << ", cache=" << n / 10
+         << (pin_threads ? ", pinned" : "") << ") ===========\n";
+
+    vector<int> thread_counts = {1, 2, 4};
+    int hw = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    for (int t = 8; t < hw; t *= 2)
+        thread_counts.push_back(t);
+    if (hw > 4)
+        thread_counts.push_back(hw);
+
+    ofstream out("benchmark_cache_threads.csv");
+    out << "subject,workload,read_percent,threads,pinned,ops_per_sec,hit_rate,thread,p50_ns,p90_ns,p99_ns,p999_ns,max_ns"
+        << perf_csv_header() << "\n";
+    cout << left << setw(12) << "subject" << setw(10) << "workload" << setw(8) << "read %" << setw(9) << "threads"
+         << setw(12) << "Mops/s" << setw(8) << "hit %" << setw(10) << "p50 ns" << setw(10) << "p99 ns"
+         << "worst thread p99\n";
+
+    // perf_* — за весь прогон, поэтому они есть только в строке "all"
+    auto row = [&](const string &subject, const string &workload, int read_percent, int threads,
+                   const CacheLoadResult &r, const string &thread, const ThreadLatency &l, const string &perf)
+    {
+        out << subject << "," << workload << "," << read_percent << "," << threads << "," << r.pinned << ","
+            << r.ops_per_sec << "," << r.hit_rate << "," << thread << "," << l.p50_ns << "," << l.p90_ns << ","
+            << l.p99_ns << "," << l.p999_ns << "," << l.max_ns << perf << "\n";
+    };
+
+    for (const string workload : {"zipf", "uniform"})
+    {
+        // 100% чтения, типичный кэш (90/10) и интенсивная запись
+        for (int read_percent : {100, 90, 50})
+        {
+            for (int threads : thread_counts)
+            {
+                for (const string subject : {"mutex", "sharded-16"})
+                {
+                    perf_discard();
+                    CacheLoadResult r = run_cache_load(subject, n, workload, read_percent, threads, ops_per_thread,
+                                                       pin_threads, 42);
+                    string perf = perf_csv_fields();
+                    double worst = 0.0;
+                    for (const ThreadLatency &l : r.threads)
+                        worst = max(worst, l.p99_ns);
+
+                    cout << fixed << setprecision(2) << left << setw(12) << subject << setw(10) << workload
+                         << setw(8) << read_percent << setw(9) << threads << setw(12) << r.ops_per_sec / 1e6
+                         << setprecision(1) << setw(8) << r.hit_rate << setprecision(0) << setw(10) << r.all.p50_ns
+                         << setw(10) << r.all.p99_ns << worst << "\n";
+
+                    row(subject, workload, read_percent, threads, r, "all", r.all, perf);
+                    for (size_t t = 0; t < r.threads.size(); ++t)
+                        row(subject, workload, read_percent, threads, r, to_string(t), r.threads[t], perf_csv_blank());
+                }
+            }
+        }
+    }
+}
+
+// ------------------------
+// Профили нагрузки: настоящий Zipf, сканы, циклы больше кэша, смещающаяся горячая зона
+// ------------------------
+void run_workload_benchmark(int n, int requests)
+{
+    cout << "\n=========== BENCHMARK: cache hit rate by workload (n=" << n << ") ===========\n";
 
+    Sequence<int> data;
+    data.reserve(n);
     for (int i = 0; i < n; ++i)
         data.push_back(i);
 
-    // ---------------------------
-    // Dictionary — вставка
-    // ---------------------------
-    Dictionary<int, int> dict;
+    size_t req = static_cast<size_t>(requests);
+    vector<size_t> cache_sizes = {static_cast<size_t>(n / 100), static_cast<size_t>(n / 10)};
+
+    ofstream out("benchmark_workloads.csv");
+    out << "workload,phase,cache_size,requests,hit_rate,ns_per_request" << perf_csv_header() << "\n";
+    cout << left << setw(20) << "workload" << setw(12) << "phase" << setw(10) << "cache" << setw(12) << "hit %"
+         << "ns/request\n";
+
+    for (size_t cache_size : cache_sizes)
+    {
+        vector<pair<string, Workload>> workloads;
+        workloads.emplace_back("uniform", Workload(n));
+        workloads.back().second.uniform(req);
+        for (double skew : {0.6, 0.9, 0.99, 1.2})
+        {
+            workloads.emplace_back("zipf-" + to_string(skew).substr(0, 4), Workload(n));
+            workloads.back().second.zipf(req, skew);
+        }
+        workloads.emplace_back("scan", Workload(n));
+        workloads.back().second.scan(req);
+        workloads.emplace_back("loop-2x-cache", Workload(n));
+        workloads.back().second.loop(req, 2 * cache_size);
+        workloads.emplace_back("shifting-hotspot", Workload(n));
+        workloads.back().second.shifting_hotspot(req, cache_size / 2, 0.9, req / 10);
+        // горячий набор, затем скан, который вытесняет его у LRU, затем снова горячий набор
+        workloads.emplace_back("mixed", Workload(n));
+        workloads.back().second.zipf(req / 2, 0.99).scan(req / 4).zipf(req / 4, 0.99);
+
+        for (auto &w : workloads)
+        {
+            CacheManager<int> cache(cache_size);
+            cache.initialize(data);
+            const vector<Workload::Phase> &phases = w.second.get_phases();
+            for (const Workload::Phase &ph : phases)
+            {
+                perf_discard();
+                ReplayResult r = replay_trace(cache, w.second.keys(), ph.begin, ph.end);
+                string phase = phases.size() > 1 ? ph.name : "all";
+                cout << fixed << setprecision(1) << left << setw(20) << w.first << setw(12) << phase << setw(10)
+                     << cache_size << setw(12) << r.hit_rate << r.ns_per_request << "\n";
+                out << w.first << "," << phase << "," << cache_size << "," << r.requests << "," << r.hit_rate << ","
+                    << r.ns_per_request << perf_csv_fields() << "\n";
+            }
+        }
+    }
+}
+
+// ------------------------
+// Память структур данных: реальные байты из учёта кучи, а не оценки
+// ------------------------
+struct MemoryCase
+{
+    string name;
+    size_t payload_per_entry; // полезные байты записи: ключ или ключ + значение
+    function<MemoryUsage(const Sequence<int> &shuffled, const Sequence<int> &sorted)> build;
+};
+
+// Каждая функция строит структуру в своей MemoryScope и снимает отчёт до её разрушения
+static vector<MemoryCase> memory_cases()
+{
+    vector<MemoryCase> cases;
+    cases.push_back({"Sequence<int> push_back", sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        Sequence<int> seq;
+        for (int k : keys)
+            seq.push_back(k);
+        return scope.report(); }});
+    cases.push_back({"Dictionary<int,int> insert", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        Dictionary<int, int> dict;
+        for (int k : keys)
+            dict.insert(k, k);
+        return scope.report(); }});
+    cases.push_back({"Dictionary<int,int> insert_bulk", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        Dictionary<int, int> dict;
+        dict.insert_bulk(keys, keys);
+        return scope.report(); }});
+    cases.push_back({"ConcurrentDictionary<int,int>", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        ConcurrentDictionary<int, int> dict;
+        for (int k : keys)
+            dict.insert(k, k);
+        return scope.report(); }});
+    cases.push_back({"std::unordered_map<int,int>", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        unordered_map<int, int> map;
+        for (int k : keys)
+            map.emplace(k, k);
+        return scope.report(); }});
+    cases.push_back({"std::map<int,int>", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        map<int, int> tree;
+        for (int k : keys)
+            tree.emplace(k, k);
+        return scope.report(); }});
+    cases.push_back({"BTree<int> insert", sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        BTree<int> tree;
+        for (int k : keys)
+            tree.insert(k);
+        return scope.report(); }});
+    cases.push_back({"BTree<int> bulk_load", sizeof(int), [](const Sequence<int> &, const Sequence<int> &sorted)
+                     {
+        MemoryScope scope;
+        BTree<int> tree;
+        tree.bulk_load(sorted);
+        return scope.report(); }});
+    cases.push_back({"BPlusTree<int,int> insert", 2 * sizeof(int), [](const Sequence<int> &keys, const Sequence<int> &)
+                     {
+        MemoryScope scope;
+        BPlusTree<int, int> tree;
+        for (int k : keys)
+            tree.insert(k, k);
+        return scope.report(); }});
+    cases.push_back({"EytzingerIndex<int>", sizeof(int), [](const Sequence<int> &, const Sequence<int> &sorted)
+                     {
+        MemoryScope scope;
+        EytzingerIndex<int> index(sorted);
+        return scope.report(); }});
+    cases.push_back({"CacheManager<int> initialize", sizeof(int), [](const Sequence<int> &, const Sequence<int> &sorted)
+                     {
+        MemoryScope scope;
+        CacheManager<int> cache(max<size_t>(1, sorted.get_size() / 10));
+        cache.initialize(sorted);
+        return scope.report(); }});
+    return cases;
+}
 
-    long long t1 = ms_now();
+void run_memory_benchmark(int n)
+{
+    cout << "\n=========== BENCHMARK: memory per data structure (n=" << n << ") ===========\n";
+    if (!memory_accounting_exact())
+        cout << "(no malloc_usable_size here: live and peak bytes are not tracked)\n";
+
+    Sequence<int> sorted;
+    sorted.reserve(n);
     for (int i = 0; i < n; ++i)
-        dict.insert(i, i);
-    long long t2 = ms_now();
-    r.insert_dict_ms = t2 - t1;
+        sorted.push_back(i);
+    Sequence<int> shuffled = sorted;
+    mt19937 gen(42);
+    shuffle(shuffled.begin(), shuffled.end(), gen);
 
-    // поиск 1000 случайных значений или всех n если n<1000
-    t1 = ms_now();
-    for (int i = 0; i < min(n, 1000); ++i)
+    ofstream out("benchmark_memory_structures.csv");
+    out << "structure,n,retained_bytes,bytes_per_entry,overhead_per_entry,peak_bytes,allocations,allocated_bytes,rss_bytes"
+        << perf_csv_header() << "\n";
+    cout << left << setw(34) << "structure" << setw(14) << "bytes" << setw(12) << "B/entry" << setw(12) << "overhead"
+         << setw(14) << "peak" << "allocations\n";
+
+    for (const MemoryCase &c : memory_cases())
     {
-        int key = i % n;
-        dict.find(key);
+        perf_discard();
+        PerfCounterScope perf;
+        MemoryUsage u = c.build(shuffled, sorted);
+        perf.stop();
+        double per_entry = static_cast<double>(u.retained_bytes) / n;
+        double overhead = per_entry - static_cast<double>(c.payload_per_entry);
+        cout << fixed << setprecision(1) << left << setw(34) << c.name << setw(14) << u.retained_bytes << setw(12)
+             << per_entry << setw(12) << overhead << setw(14) << u.peak_bytes << u.allocations << "\n";
+        out << c.name << "," << n << "," << u.retained_bytes << "," << per_entry << "," << overhead << ","
+            << u.peak_bytes << "," << u.allocations << "," << u.allocated_bytes << "," << u.rss_bytes
+            << perf_csv_fields() << "\n";
     }
-    t2 = ms_now();
-    r.search_dict_ms = t2 - t1;
+}
 
-    // ---------------------------
-    // BTree — вставка
-    // ---------------------------
-    BTree<int> tree;
+// ------------------------
+// Кейсы для отдельного бинарника bench_main: фиксированный seed, разогрев, повторы
+// ------------------------
+static Measurements cache_case(size_t data_size, size_t cache_size, size_t requests, bool zipf, uint32_t seed)
+{
+    Sequence<int> data;
+    data.reserve(data_size);
+    for (size_t i = 0; i < data_size; ++i)
+        data.push_back(static_cast<int>(i));
+
+    CacheBenchmark<int> bench(LatencyModel::constant(2.0), WaitMode::Spin, seed);
+    CacheManager<int> cache(cache_size);
+    BenchmarkResult r = bench.run_cache_test(cache, zipf ? "zipf" : "uniform", data, requests, zipf);
+    return {{"cache_ms", r.time_cache_total_ms},
+            {"storage_lookup_ms", r.time_storage_total_ms},
+            {"storage_build_ms", r.time_storage_build_ms},
+            {"hit_rate", r.hit_rate},
+            {"speedup", r.speedup}};
+}
+
+static Measurements workload_case(size_t cache_size, const Workload &workload)
+{
+    Sequence<int> data;
+    data.reserve(workload.get_key_space());
+    for (size_t i = 0; i < workload.get_key_space(); ++i)
+        data.push_back(static_cast<int>(i));
+    CacheManager<int> cache(cache_size);
+    cache.initialize(data);
+    ReplayResult r = replay_trace(cache, workload.keys());
+    return {{"ms", r.elapsed_ms}, {"ns_per_request", r.ns_per_request}, {"hit_rate", r.hit_rate}};
+}
 
-    t1 = ms_now();
+static Sequence<int> shuffled_keys(int n, uint32_t seed)
+{
+    Sequence<int> keys;
+    keys.reserve(n);
     for (int i = 0; i < n; ++i)
-        tree.insert(i);
-    t2 = ms_now();
-    r.insert_tree_ms = t2 - t1;
+        keys.push_back(i);
+    mt19937 gen(seed);
+    shuffle(keys.begin(), keys.end(), gen);
+    return keys;
+}
 
-    // ---------------------------
-    // поиск
-    // ---------------------------
-    t1 = ms_now();
-    for (int i = 0; i < min(n, 1000); ++i)
+void register_harness_benchmarks(BenchmarkHarness &harness)
+{
+    harness.add("cache/zipf/lfu-1000", [](uint32_t seed)
+                { return cache_case(100000, 1000, 100000, true, seed); });
+    harness.add("cache/zipf/lfu-10000", [](uint32_t seed)
+                { return cache_case(100000, 10000, 100000, true, seed); });
+    harness.add("cache/uniform/lfu-1000", [](uint32_t seed)
+                { return cache_case(100000, 1000, 100000, false, seed); });
+    harness.add("cache/loop-2x/lfu-1000", [](uint32_t seed)
+                {
+        Workload w(100000, seed);
+        w.loop(200000, 2000);
+        return workload_case(1000, w); });
+    harness.add("cache/shifting-hotspot/lfu-1000", [](uint32_t seed)
+                {
+        Workload w(100000, seed);
+        w.shifting_hotspot(200000, 500, 0.9, 20000);
+        return workload_case(1000, w); });
+    harness.add("cache/mixed/lfu-1000", [](uint32_t seed)
+                {
+        Workload w(100000, seed);
+        w.zipf(100000, 0.99).scan(50000).zipf(50000, 0.99);
+        return workload_case(1000, w); });
+
+    // the same cache shared by one thread and by all hardware threads
+    int hw = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    for (int threads : hw > 1 ? vector<int>{1, hw} : vector<int>{1, 4})
+        for (const string subject : {"mutex", "sharded-16"})
+        {
+            bool pin = harness.get_options().pin_threads;
+            harness.add("cache-threads/zipf-rw90/" + subject + "-" + to_string(threads) + "t", [=](uint32_t seed)
+                        {
+                CacheLoadResult r = run_cache_load(subject, 100000, "zipf", 90, threads, 200000, pin, seed);
+                double worst = 0.0;
+                for (const ThreadLatency &l : r.threads)
+                    worst = max(worst, l.p99_ns);
+                return Measurements{{"mops", r.ops_per_sec / 1e6}, {"hit_rate", r.hit_rate}, {"p50_ns", r.all.p50_ns},
+                                    {"p99_ns", r.all.p99_ns}, {"p999_ns", r.all.p999_ns}, {"worst_thread_p99_ns", worst}}; });
+        }
+
+    // memory: deterministic, so one repetition would do; kept in the same format
+    for (const MemoryCase &c : memory_cases())
     {
-        int key = i % n;
-        tree.search(key);
+        if (c.name.find("std::") == 0)
+            continue;
+        string name = "memory/" + c.name.substr(0, c.name.find('<')) + c.name.substr(c.name.find('>') + 1);
+        for (char &ch : name)
+            if (ch == ' ')
+                ch = '-';
+        harness.add(name + "-1M", [c](uint32_t seed)
+                    {
+            Sequence<int> sorted = shuffled_keys(1000000, seed);
+            Sequence<int> shuffled = sorted;
+            sort(sorted.begin(), sorted.end());
+            MemoryUsage u;
+            {
+                PerfCounterScope perf;
+                u = c.build(shuffled, sorted);
+            }
+            return Measurements{{"retained_bytes", static_cast<double>(u.retained_bytes)},
+                                {"bytes_per_entry", u.retained_bytes / 1e6},
+                                {"peak_bytes", static_cast<double>(u.peak_bytes)},
+                                {"allocations", static_cast<double>(u.allocations)}}; });
     }
-    t2 = ms_now();
-    r.search_tree_ms = t2 - t1;
 
-    // ---------------------------
-    // Память
-    // ---------------------------
-    r.mem_dict = estimate_memory_dictionary(dict.get_size());
-    r.mem_tree = estimate_memory_btree(tree.get_size());
+    // --trace FILE: a captured trace, read and renumbered once, replayed every repetition
+    const BenchmarkHarness::Options &options = harness.get_options();
+    if (!options.trace.empty())
+    {
+        auto keys = make_shared<Sequence<int>>(AccessTrace::read(options.trace));
+        size_t distinct = AccessTrace::compact_keys(*keys);
+        size_t cache_size = options.trace_cache;
+        string name = "trace/" + filesystem::path(options.trace).filename().string() + "/lfu-" + to_string(cache_size);
+        harness.add(name, [keys, distinct, cache_size](uint32_t)
+                    {
+            Sequence<int> data;
+            data.reserve(distinct);
+            for (size_t i = 0; i < distinct; ++i)
+                data.push_back(static_cast<int>(i));
+            CacheManager<int> cache(cache_size);
+            cache.initialize(data);
+            ReplayResult r = replay_trace(cache, *keys);
+            return Measurements{{"ms", r.elapsed_ms}, {"ns_per_request", r.ns_per_request}, {"hit_rate", r.hit_rate}}; });
+    }
 
-    return r;
+    harness.add("dictionary/insert_bulk-1M", [](uint32_t seed)
+                {
+        Sequence<int> keys = shuffled_keys(1000000, seed);
+        Dictionary<int, int> dict;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              { dict.insert_bulk(keys, keys); });
+        return Measurements{{"ms", ms}}; });
+
+    harness.add("dictionary/find-1M", [](uint32_t seed)
+                {
+        Sequence<int> keys = shuffled_keys(1000000, seed);
+        Dictionary<int, int> dict;
+        dict.insert_bulk(keys, keys);
+        long long sink = 0;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              {
+            for (int k : keys)
+                sink += *dict.find(k); });
+        benchmark_sink = sink;
+        return Measurements{{"ms", ms}, {"ns_per_lookup", ms * 1e6 / keys.get_size()}}; });
+
+    harness.add("btree/insert-1M", [](uint32_t seed)
+                {
+        Sequence<int> keys = shuffled_keys(1000000, seed);
+        BTree<int> tree;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              {
+            for (int k : keys)
+                tree.insert(k); });
+        return Measurements{{"ms", ms}}; });
+
+    harness.add("btree/search-1M", [](uint32_t seed)
+                {
+        Sequence<int> sorted;
+        sorted.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i)
+            sorted.push_back(i);
+        BTree<int> tree;
+        tree.bulk_load(sorted);
+        Sequence<int> probes = shuffled_keys(1000000, seed);
+        long long sink = 0;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              {
+            for (int k : probes)
+                sink += tree.contains(k); });
+        benchmark_sink = sink;
+        return Measurements{{"ms", ms}, {"ns_per_lookup", ms * 1e6 / probes.get_size()}}; });
+
+    harness.add("eytzinger/search-1M", [](uint32_t seed)
+                {
+        Sequence<int> sorted;
+        sorted.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i)
+            sorted.push_back(i);
+        EytzingerIndex<int> index(sorted);
+        Sequence<int> probes = shuffled_keys(1000000, seed);
+        long long sink = 0;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              {
+            for (int k : probes)
+                sink += index.contains(k); });
+        benchmark_sink = sink;
+        return Measurements{{"ms", ms}, {"ns_per_lookup", ms * 1e6 / probes.get_size()}}; });
+
+    harness.add("sequence/find-int-16M", [](uint32_t seed)
+                {
+        Sequence<int> data = shuffled_keys(1 << 24, seed);
+        long long sink = 0;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              {
+            for (int r = 0; r < 10; ++r)
+                sink += data.find(-1 - r); });
+        benchmark_sink = sink;
+        return Measurements{{"ms", ms}, {"gb_per_s", 10.0 * data.get_size() * sizeof(int) / (ms * 1e6)}}; });
+
+    harness.add("parallel/sort-2M", [](uint32_t seed)
+                {
+        Sequence<int> data = shuffled_keys(2000000, seed);
+        // свой пул, а не ThreadPool::global(): его рабочие запускаются после PerfCounters::enable()
+        // и наследуют счётчики, иначе perf_* видели бы только вызывающий поток
+        ThreadPool pool;
+        double ms = BenchmarkHarness::time_ms([&]
+                                              { parallel_sort(data, less<int>(), pool); });
+        return Measurements{{"ms", ms}}; });
+}
+
+// Открыть счётчики до первого замера и до того, как кто-то запустит потоки
+static void open_perf_counters()
+{
+    PerfCounters &perf = PerfCounters::session();
+    if (perf.enable())
+    {
+        cout << "perf counters:";
+        for (const string &e : perf.available_events())
+            cout << " " << e;
+        cout << "\n";
+    }
+    else
+        cout << "perf counters unavailable, perf_* columns stay empty\n";
 }
 
 // Запуск всех тестов
 void run_all_benchmarks()
 {
+    open_perf_counters();
     cout << "\n=========== BENCHMARK: HashTable vs BTree ===========\n";
 
     vector<int> sizes = {10, 100, 1000, 10000};
@@ -133,8 +2542,10 @@ void run_all_benchmarks()
         cout << "Dictionary search: " << r.search_dict_ms << " ms\n";
         cout << "BTree insert:      " << r.insert_tree_ms << " ms\n";
         cout << "BTree search:      " << r.search_tree_ms << " ms\n";
-        cout << "Approx memory Dictionary: " << r.mem_dict << " bytes\n";
-        cout << "Approx memory BTree:      " << r.mem_tree << " bytes\n";
+        cout << "Memory Dictionary: " << r.mem_dict.retained_bytes << " bytes (peak " << r.mem_dict.peak_bytes
+             << ", " << r.mem_dict.allocations << " allocations)\n";
+        cout << "Memory BTree:      " << r.mem_tree.retained_bytes << " bytes (peak " << r.mem_tree.peak_bytes
+             << ", " << r.mem_tree.allocations << " allocations)\n";
 
         results.push_back(r);
     }
@@ -144,14 +2555,15 @@ void run_all_benchmarks()
     // ---------------------------------------------
     {
         ofstream out("benchmark_speed.csv");
-        out << "n,dict_insert_ms,dict_search_ms,btree_insert_ms,btree_search_ms\n";
+        out << "n,dict_insert_ms,dict_search_ms,btree_insert_ms,btree_search_ms" << perf_csv_header() << "\n";
         for (auto &r : results)
         {
             out << r.n << ","
                 << r.insert_dict_ms << ","
                 << r.search_dict_ms << ","
                 << r.insert_tree_ms << ","
-                << r.search_tree_ms << "\n";
+                << r.search_tree_ms
+                << r.perf << "\n";
         }
     }
 
@@ -160,12 +2572,16 @@ void run_all_benchmarks()
     // ---------------------------------------------
     {
         ofstream out("benchmark_memory.csv");
-        out << "n,dict_memory,btree_memory\n";
+        out << "n,dict_memory,btree_memory,dict_peak,btree_peak,dict_allocations,btree_allocations\n";
         for (auto &r : results)
         {
             out << r.n << ","
-                << r.mem_dict << ","
-                << r.mem_tree << "\n";
+                << r.mem_dict.retained_bytes << ","
+                << r.mem_tree.retained_bytes << ","
+                << r.mem_dict.peak_bytes << ","
+                << r.mem_tree.peak_bytes << ","
+                << r.mem_dict.allocations << ","
+                << r.mem_tree.allocations << "\n";
         }
     }
 
@@ -189,11 +2605,59 @@ void run_all_benchmarks()
              << setw(18) << r.search_dict_ms
              << setw(18) << r.insert_tree_ms
              << setw(18) << r.search_tree_ms
-             << setw(18) << r.mem_dict
-             << setw(18) << r.mem_tree
+             << setw(18) << r.mem_dict.retained_bytes
+             << setw(18) << r.mem_tree.retained_bytes
              << "\n";
     }
 
-    cout << "\nCSV файлы созданы: benchmark_speed.csv, benchmark_memory.csv\n";
+    run_memory_benchmark(1000000);
+    run_person_encoding_benchmark(100000);
+    run_sequence_allocation_benchmark(100000);
+    run_small_sequence_benchmark(1000000);
+    run_dictionary_bulk_benchmark(1000000);
+    run_segmented_sequence_benchmark(1000000);
+    run_mapped_sequence_benchmark(5000000, 1000000);
+    run_parallel_benchmark(2000000);
+    run_simd_search_benchmark(size_t(1) << 24);
+    run_tree_benchmarks();
+    run_range_scan_benchmark(1000000, 1000, 1000);
+    run_bulk_load_benchmark();
+    run_btree_mixed_benchmark(200000, 1000000);
+    run_btree_node_benchmark(10000000);
+    run_concurrency_benchmark(1000000, 500000);
+    run_concurrent_dictionary_benchmark(1000000, 500000);
+    run_paged_btree_benchmark(1000000, 200000);
+    run_slow_storage_benchmark(100000, 20000);
+    run_workload_benchmark(100000, 1000000);
+    run_cache_threads_benchmark(100000, 200000, false);
+    run_eytzinger_benchmark({1000000, 10000000}, 1000000);
+    run_record_index_benchmark(200000);
+
+    cout << "\nCSV файлы созданы: benchmark_speed.csv, benchmark_memory.csv, benchmark_person_encoding.csv, benchmark_trees.csv, benchmark_range_scan.csv,\n"
+         << "             benchmark_bulk_load.csv, benchmark_btree_mixed.csv,\n"
+         << "             benchmark_record_index.csv, benchmark_btree_nodes.csv,\n"
+         << "             benchmark_concurrency.csv, benchmark_paged_btree.csv,\n"
+         << "             benchmark_slow_storage.csv, benchmark_storage_queue.csv, benchmark_eytzinger.csv,\n"
+         << "             benchmark_sequence_alloc.csv, benchmark_small_sequence.csv, benchmark_segmented.csv,\n"
+         << "             benchmark_mapped.csv, benchmark_parallel.csv,\n"
+         << "             benchmark_simd.csv, benchmark_concurrent_dictionary.csv,\n"
+         << "             benchmark_dictionary_bulk.csv, benchmark_workloads.csv,\n"
+         << "             benchmark_cache_threads.csv, benchmark_memory_structures.csv\n";
     cout << "=========== BENCHMARK FINISHED ===========\n\n";
+    PerfCounters::session().disable();
+}
+
+// ------------------------
+// Большие размеры (сотни миллионов элементов, несколько ГБ памяти) — только по запросу
+// ------------------------
+void run_large_benchmarks()
+{
+    open_perf_counters();
+    run_segmented_sequence_benchmark(100000000);
+    run_simd_search_benchmark(200000000);
+    run_eytzinger_benchmark({100000000}, 1000000);
+
+    cout << "\nCSV файлы перезаписаны: benchmark_segmented.csv, benchmark_simd.csv, benchmark_eytzinger.csv\n";
+    cout << "=========== LARGE BENCHMARKS FINISHED ===========\n\n";
+    PerfCounters::session().disable();
 }
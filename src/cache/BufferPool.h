@@ -0,0 +1,294 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include "../data_structures/Sequence.h"
+#include "CacheStats.h"
+#include "LfuPolicy.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Fixed-size page I/O on a single file (pread/pwrite on POSIX, stdio elsewhere)
+class PageFile
+{
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+private:
+#ifndef _WIN32
+    int fd;
+#else
+    std::FILE *file;
+#endif
+    size_t reads;
+    size_t writes;
+
+public:
+    explicit PageFile(const std::string &path) : reads(0), writes(0)
+    {
+#ifndef _WIN32
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            throw std::runtime_error("PageFile: cannot open " + path);
+#else
+        file = std::fopen(path.c_str(), "r+b");
+        if (!file)
+            file = std::fopen(path.c_str(), "w+b");
+        if (!file)
+            throw std::runtime_error("PageFile: cannot open " + path);
+#endif
+    }
+
+    ~PageFile()
+    {
+#ifndef _WIN32
+        ::close(fd);
+#else
+        std::fclose(file);
+#endif
+    }
+
+    PageFile(const PageFile &) = delete;
+    PageFile &operator=(const PageFile &) = delete;
+
+    size_t page_count() const
+    {
+#ifndef _WIN32
+        off_t end = ::lseek(fd, 0, SEEK_END);
+        return end < 0 ? 0 : static_cast<size_t>(end) / PAGE_SIZE;
+#else
+        std::fseek(file, 0, SEEK_END);
+        return static_cast<size_t>(std::ftell(file)) / PAGE_SIZE;
+#endif
+    }
+
+    void read(uint32_t page_id, char *out)
+    {
+        reads++;
+        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+#ifndef _WIN32
+        ssize_t n = ::pread(fd, out, PAGE_SIZE, static_cast<off_t>(offset));
+        size_t got = n < 0 ? 0 : static_cast<size_t>(n);
+#else
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        size_t got = std::fread(out, 1, PAGE_SIZE, file);
+#endif
+        // pages past the end of file read as zeros
+        if (got < PAGE_SIZE)
+            std::memset(out + got, 0, PAGE_SIZE - got);
+    }
+
+    void write(uint32_t page_id, const char *data)
+    {
+        writes++;
+        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+#ifndef _WIN32
+        if (::pwrite(fd, data, PAGE_SIZE, static_cast<off_t>(offset)) != static_cast<ssize_t>(PAGE_SIZE))
+            throw std::runtime_error("PageFile: write failed");
+#else
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        if (std::fwrite(data, 1, PAGE_SIZE, file) != PAGE_SIZE)
+            throw std::runtime_error("PageFile: write failed");
+#endif
+    }
+
+    void sync()
+    {
+#ifndef _WIN32
+        if (::fsync(fd) != 0)
+            throw std::runtime_error("PageFile: sync failed");
+#else
+        if (std::fflush(file) != 0)
+            throw std::runtime_error("PageFile: sync failed");
+#endif
+    }
+
+    // Write the file to disk and ask the OS to drop it from its page cache,
+    // so the next open really reads from the device. False if unsupported.
+    static bool drop_os_cache(const std::string &path)
+    {
+#if defined(POSIX_FADV_DONTNEED)
+        int f = ::open(path.c_str(), O_RDONLY);
+        if (f < 0)
+            return false;
+        bool ok = ::fsync(f) == 0 && ::posix_fadvise(f, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        ::close(f);
+        return ok;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    size_t get_reads() const { return reads; }
+    size_t get_writes() const { return writes; }
+};
+
+/**
+ * @brief Page cache in front of a PageFile.
+ *
+ * Holds up to `capacity` pages in memory. Replacement decisions come from
+ * LfuPolicy, the same LFU machinery CacheManager uses for records; pinned
+ * pages are skipped. Dirty pages are written back on eviction and flush.
+ * Write errors are thrown by fetch/create/flush_all; the destructor makes a
+ * last flush attempt and swallows errors, so call flush_all() to see them.
+ * Statistics are reported as CacheStats (hits, misses, evictions).
+ */
+class BufferPool
+{
+public:
+    static constexpr size_t PAGE_SIZE = PageFile::PAGE_SIZE;
+
+private:
+    struct Frame
+    {
+        uint32_t page_id;
+        int pin_count;
+        bool dirty;
+        char *data;
+
+        Frame() : page_id(0), pin_count(0), dirty(false), data(nullptr) {}
+    };
+
+    PageFile &file;
+    size_t capacity;
+    std::unique_ptr<char[]> memory;
+    Sequence<Frame> frames;
+    Sequence<size_t> free_frames;
+    std::unordered_map<uint32_t, size_t> page_table;
+    LfuPolicy policy;
+    CacheStats stats;
+
+    size_t take_frame()
+    {
+        if (!free_frames.is_empty())
+        {
+            size_t f = free_frames[free_frames.get_size() - 1];
+            free_frames.pop_back();
+            return f;
+        }
+
+        int victim;
+        bool found = policy.pop_victim_if(victim, [this](int page)
+                                          { return frames[page_table[static_cast<uint32_t>(page)]].pin_count == 0; });
+        if (!found)
+            throw std::runtime_error("BufferPool: all pages are pinned");
+
+        uint32_t victim_page = static_cast<uint32_t>(victim);
+        size_t f = page_table[victim_page];
+        if (frames[f].dirty)
+            file.write(victim_page, frames[f].data);
+        page_table.erase(victim_page);
+        stats.evictions++;
+        return f;
+    }
+
+    char *install(uint32_t page_id, size_t f, bool dirty)
+    {
+        frames[f].page_id = page_id;
+        frames[f].pin_count = 1;
+        frames[f].dirty = dirty;
+        page_table[page_id] = f;
+        policy.insert(static_cast<int>(page_id));
+        return frames[f].data;
+    }
+
+public:
+    BufferPool(PageFile &page_file, size_t capacity_pages)
+        : file(page_file), capacity(capacity_pages)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("BufferPool capacity must be > 0");
+        memory.reset(new char[capacity * PAGE_SIZE]);
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            Frame fr;
+            fr.data = memory.get() + i * PAGE_SIZE;
+            frames.push_back(fr);
+            free_frames.push_back(capacity - 1 - i);
+        }
+    }
+
+    ~BufferPool()
+    {
+        try
+        {
+            flush_all();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    // Pin a page, reading it from disk on a miss
+    char *fetch(uint32_t page_id)
+    {
+        stats.total_accesses++;
+        auto it = page_table.find(page_id);
+        if (it != page_table.end())
+        {
+            stats.hits++;
+            frames[it->second].pin_count++;
+            policy.touch(static_cast<int>(page_id));
+            return frames[it->second].data;
+        }
+
+        stats.misses++;
+        size_t f = take_frame();
+        file.read(page_id, frames[f].data);
+        return install(page_id, f, false);
+    }
+
+    // Pin a brand-new zeroed page (not read from disk)
+    char *create(uint32_t page_id)
+    {
+        size_t f = take_frame();
+        std::memset(frames[f].data, 0, PAGE_SIZE);
+        return install(page_id, f, true);
+    }
+
+    void unpin(uint32_t page_id, bool dirty)
+    {
+        auto it = page_table.find(page_id);
+        if (it == page_table.end() || frames[it->second].pin_count == 0)
+            throw std::logic_error("BufferPool: unpin of a page that is not pinned");
+        frames[it->second].pin_count--;
+        if (dirty)
+            frames[it->second].dirty = true;
+    }
+
+    // Write back every dirty page; throws std::runtime_error on a failed write
+    void flush_all()
+    {
+        for (auto &p : page_table)
+        {
+            Frame &fr = frames[p.second];
+            if (fr.dirty)
+            {
+                file.write(p.first, fr.data);
+                fr.dirty = false;
+            }
+        }
+    }
+
+    CacheStats get_statistics() const
+    {
+        CacheStats s = stats;
+        s.hit_rate = s.total_accesses > 0 ? (100.0 * s.hits) / s.total_accesses : 0.0;
+        return s;
+    }
+
+    size_t get_capacity() const { return capacity; }
+    size_t get_resident() const { return page_table.size(); }
+};
@@ -2,160 +2,187 @@
 
 #include <stdexcept>
 #include <unordered_map>
-#include <list>
 #include "../data_structures/BTree.h"
 #include "../data_structures/Sequence.h"
+#include "../data_structures/SmallSequence.h"
+#include "../data_structures/SegmentedSequence.h"
+#include "../data_structures/MappedSequence.h"
 #include "CacheEntry.h"
 #include "CacheStats.h"
+#include "DiskTier.h"
+#include "LfuPolicy.h"
+#include "SlowStorage.h"
 #include <chrono>
 #include <algorithm>
+#include <memory>
 
 template <typename T>
 class CacheManager
 {
+public:
+    // Key snapshot returned by get_cache_keys(); small caches fit without a heap allocation
+    using KeyList = SmallSequence<int, 16>;
+
 private:
     size_t max_cache_size;
 
     // core cache storage: key -> CacheEntry
     std::unordered_map<int, CacheEntry<T>> cache_map;
 
-    // frequency lists: freq -> list of keys with that freq (front: most-recent-with-this-freq)
-    std::unordered_map<size_t, std::list<int>> freq_lists;
+    // LFU replacement state (frequency lists, min frequency)
+    LfuPolicy policy;
 
-    // map key -> iterator in corresponding list (for O(1) removal)
-    std::unordered_map<int, typename std::list<int>::iterator> key_iter_map;
+    // underlying "slow" storage (no simulated latency unless configured)
+    SlowStorage<T> storage;
+    // records by position; chunked, so addresses stay stable and loading never copies twice
+    SegmentedSequence<T> all_data;
 
-    // map key -> current frequency
-    std::unordered_map<int, size_t> key_freq_map;
+    // read-only file mapping used instead of all_data/storage after initialize_mapped()
+    std::unique_ptr<MappedSequence<T>> mapped;
 
-    // minimal frequency currently in cache (to quickly evict LFU)
-    size_t min_freq;
-
-    // underlying "slow" storage
-    BTree<T> storage;
-    Sequence<T> all_data;
+    // optional second tier for evicted entries (nullptr when disabled)
+    std::unique_ptr<DiskTier<T>> l2;
 
     // statistics
     CacheStats stats;
 
-    // helper: touch key -> increase its frequency
-    void touch(int key)
+    // Record at position i of the backing data (mapped file or all_data), nullptr if out of range
+    const T *backing_at(size_t i) const
     {
-        auto itf = key_freq_map.find(key);
-        if (itf == key_freq_map.end())
-            return; // shouldn't happen
-
-        size_t freq = itf->second;
-        // remove from old freq list
-        auto &old_list = freq_lists[freq];
-        auto it_key_it = key_iter_map.find(key);
-        if (it_key_it != key_iter_map.end())
-            old_list.erase(it_key_it->second);
-
-        // if old list is empty and freq == min_freq, increment min_freq
-        if (old_list.empty() && freq == min_freq)
-            min_freq++;
-
-        // insert into new list with freq+1 at front (recently used)
-        size_t newf = freq + 1;
-        freq_lists[newf].push_front(key);
-        key_iter_map[key] = freq_lists[newf].begin();
-        key_freq_map[key] = newf;
+        if (mapped)
+            return i < mapped->get_size() ? &(*mapped)[i] : nullptr;
+        return i < all_data.get_size() ? &all_data[i] : nullptr;
+    }
+
+    void reset_and_preload()
+    {
+        // clear cache structures
+        cache_map.clear();
+        policy.clear();
+        stats = CacheStats();
+        storage.reset_statistics();
+        if (l2)
+            l2->clear();
+
+        // Preload cache with first min(max_cache_size, data_size) items
+        for (size_t i = 0; i < max_cache_size; ++i)
+        {
+            const T *record = backing_at(i);
+            if (!record)
+                break;
+            int key = static_cast<int>(i);
+            CacheEntry<T> e(*record);
+            e.access_count = 1;
+            e.last_access = std::chrono::steady_clock::now();
+            cache_map[key] = e;
+            policy.insert(key);
+        }
     }
 
     void evict_one()
     {
         if (cache_map.empty())
             return;
-        // find list for min_freq
-        auto it = freq_lists.find(min_freq);
-        if (it == freq_lists.end() || it->second.empty())
+
+        int victim_key;
+        if (!policy.pop_victim(victim_key))
+            return;
+
+        // spill the victim to the disk tier so the next access avoids the slow storage
+        if (l2)
         {
-            // find next non-empty freq
-            for (auto &p : freq_lists)
-            {
-                if (!p.second.empty())
-                {
-                    min_freq = p.first;
-                    break;
-                }
-            }
-            it = freq_lists.find(min_freq);
-            if (it == freq_lists.end() || it->second.empty())
-                return;
+            auto victim_it = cache_map.find(victim_key);
+            if (victim_it != cache_map.end() && l2->put(victim_key, victim_it->second.data))
+                stats.l2_writes++;
         }
 
-        // Evict the least recently used among those with min_freq -> take back()
-        int victim_key = it->second.back();
-        it->second.pop_back();
-
-        // erase maps
-        key_iter_map.erase(victim_key);
-        key_freq_map.erase(victim_key);
         cache_map.erase(victim_key);
-
         stats.evictions++;
-        // if the list became empty, erase it
-        if (it->second.empty())
-            freq_lists.erase(it);
+    }
+
+    // Insert a missed value into the cache, evicting if needed
+    T *admit(int key, const T &value, std::chrono::steady_clock::time_point start)
+    {
+        if (cache_map.size() >= max_cache_size)
+        {
+            evict_one();
+        }
+
+        CacheEntry<T> e(value);
+        e.access_count = 1;
+        e.last_access = std::chrono::steady_clock::now();
+        cache_map[key] = e;
+        policy.insert(key);
+
+        auto cached_it = cache_map.find(key);
+
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+        stats.avg_access_time_cache = (stats.avg_access_time_cache * (stats.hits + stats.misses - 1) + elapsed) / (stats.hits + stats.misses);
+
+        return &cached_it->second.data;
     }
 
 public:
-    CacheManager(size_t capacity = 100) : max_cache_size(capacity), min_freq(0)
+    CacheManager(size_t capacity = 100) : max_cache_size(capacity)
     {
         if (capacity == 0)
             throw std::invalid_argument("Cache capacity must be > 0");
         stats = CacheStats();
     }
 
+    // Enable the disk-backed L2 tier; segment files are created under `directory`
+    void enable_disk_tier(const std::string &directory, size_t segment_bytes = 1 << 20, size_t max_segments = 16)
+    {
+        l2.reset(new DiskTier<T>(directory, segment_bytes, max_segments));
+        if (!l2->is_available())
+            l2.reset();
+    }
+
+    void disable_disk_tier() { l2.reset(); }
+
+    // Simulated miss penalty of the backing storage
+    void set_storage_latency(const LatencyModel &latency, size_t max_in_flight = 1, WaitMode mode = WaitMode::Spin)
+    {
+        storage.configure(latency, max_in_flight, mode);
+    }
+
+    // Index used for the backing storage; takes effect on the next initialize()
+    void set_storage_index(StorageIndex kind) { storage.set_index(kind); }
+
+    SlowStorageStats get_storage_statistics() const { return storage.get_statistics(); }
+    bool has_disk_tier() const { return l2 != nullptr; }
+    size_t get_disk_tier_size() const { return l2 ? l2->get_size() : 0; }
+
     void debug_dump_freq() const
     {
         std::cout << "\n[FREQ LISTS]\n";
-        for (auto &p : freq_lists)
-        {
-            size_t freq = p.first;
-            std::cout << "freq " << freq << ": ";
-
-            for (int k : p.second)
-                std::cout << k << " ";
-            std::cout << "\n";
-        }
-        std::cout << "min_freq = " << min_freq << "\n";
+        policy.dump(std::cout);
     }
 
     void initialize(const Sequence<T> &data)
     {
         // prepare slow storage
-        all_data = data;
-        storage.clear();
-        for (size_t i = 0; i < data.get_size(); ++i)
-            storage.insert(data[i]);
-
-        // clear cache structures
-        cache_map.clear();
-        freq_lists.clear();
-        key_iter_map.clear();
-        key_freq_map.clear();
-        min_freq = 0;
-        stats = CacheStats();
+        mapped.reset();
+        all_data.assign(data);
+        storage.load(data);
+        reset_and_preload();
+    }
 
-        // Preload cache with first min(max_cache_size, data_size) items
-        size_t preload = std::min(max_cache_size, data.get_size());
-        for (size_t i = 0; i < preload; ++i)
-        {
-            int key = static_cast<int>(i);
-            CacheEntry<T> e(all_data[i]);
-            e.access_count = 1;
-            e.last_access = std::chrono::steady_clock::now();
-            cache_map[key] = e;
-            key_freq_map[key] = 1;
-            freq_lists[1].push_front(key);
-            key_iter_map[key] = freq_lists[1].begin();
-        }
-        if (preload > 0)
-            min_freq = 1;
+    // Serve misses straight from a record file (see MappedSequence::write_file),
+    // key = record position. Nothing is copied: the OS page cache is the cold tier.
+    // Requires a trivially copyable T.
+    void initialize_mapped(const std::string &path)
+    {
+        std::unique_ptr<MappedSequence<T>> file(new MappedSequence<T>(path));
+        mapped = std::move(file);
+        all_data.clear();
+        storage.clear();
+        reset_and_preload();
     }
 
+    bool is_mapped() const { return mapped != nullptr; }
+
     // get returns pointer to data in cache (or loads it)
     T *get(int key)
     {
@@ -170,7 +197,7 @@ public:
             it->second.access_count++;
             it->second.last_access = std::chrono::steady_clock::now();
             stats.hits++;
-            touch(key);
+            policy.touch(key);
 
             auto end = std::chrono::steady_clock::now();
             double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
@@ -179,12 +206,25 @@ public:
             return &it->second.data;
         }
 
-        // Miss: try to get from all_data by index (fast path)
+        // Miss: try the disk tier first, then the backing data by index (fast path)
         stats.misses++;
-        T *value_ptr = nullptr;
-        if (key >= 0 && static_cast<size_t>(key) < all_data.get_size())
+        const T *value_ptr = nullptr;
+        const T *record = nullptr;
+        if (l2)
         {
-            value_ptr = &all_data[static_cast<size_t>(key)];
+            // constructed only when a disk tier exists; promote a hit back into memory
+            T l2_value;
+            if (l2->get(key, l2_value))
+            {
+                l2->erase(key);
+                stats.l2_hits++;
+                return admit(key, l2_value, start);
+            }
+        }
+        if (key >= 0 && (record = backing_at(static_cast<size_t>(key))) != nullptr)
+        {
+            storage.access();
+            value_ptr = record;
         }
         else
         {
@@ -195,28 +235,43 @@ public:
         if (!value_ptr)
             return nullptr;
 
-        // Insert into cache, evicting if needed
-        if (cache_map.size() >= max_cache_size)
+        return admit(key, *value_ptr, start);
+    }
+
+    // Cache-aside write: store `value` under `key`, replacing a cached copy;
+    // the backing data is left alone. Counts as a use for LFU, not as a hit or miss.
+    void put(int key, const T &value)
+    {
+        auto it = cache_map.find(key);
+        if (it != cache_map.end())
         {
-            evict_one();
+            it->second.data = value;
+            it->second.access_count++;
+            it->second.last_access = std::chrono::steady_clock::now();
+            policy.touch(key);
+            return;
         }
 
-        CacheEntry<T> e(*value_ptr);
+        // an older copy in the disk tier would come back on the next miss
+        if (l2)
+            l2->erase(key);
+        if (cache_map.size() >= max_cache_size)
+            evict_one();
+
+        CacheEntry<T> e(value);
         e.access_count = 1;
-        e.last_access = std::chrono::steady_clock::now();
         cache_map[key] = e;
-        key_freq_map[key] = 1;
-        freq_lists[1].push_front(key);
-        key_iter_map[key] = freq_lists[1].begin();
-        min_freq = 1;
-
-        auto cached_it = cache_map.find(key);
-
-        auto end = std::chrono::steady_clock::now();
-        double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
-        stats.avg_access_time_cache = (stats.avg_access_time_cache * (stats.hits + stats.misses - 1) + elapsed) / (stats.hits + stats.misses);
+        policy.insert(key);
+    }
 
-        return &cached_it->second.data;
+    // Drop `key` from both tiers; the next get() reloads it from the backing data
+    bool invalidate(int key)
+    {
+        bool dropped = l2 && l2->erase(key);
+        if (cache_map.erase(key) == 0)
+            return dropped;
+        policy.erase(key);
+        return true;
     }
 
     // Inspectors
@@ -224,7 +279,10 @@ public:
     {
         CacheStats s = stats;
         s.hit_rate = s.total_accesses > 0 ? (100.0 * s.hits) / s.total_accesses : 0.0;
-        // storage avg is unknown; keep default
+        // simulated storage time per request (queueing included), in ms like the cache average
+        SlowStorageStats st = storage.get_statistics();
+        if (st.requests > 0)
+            s.avg_access_time_storage = (st.total_latency_us + st.total_queue_us) / st.requests / 1000.0;
         s.speedup = (s.avg_access_time_cache > 0.0) ? (s.avg_access_time_storage / s.avg_access_time_cache) : 1.0;
         return s;
     }
@@ -240,12 +298,13 @@ public:
 
     size_t get_cache_size() const { return cache_map.size(); }
     size_t get_max_cache_size() const { return max_cache_size; }
-    size_t get_storage_size() const { return storage.get_size(); }
+    size_t get_storage_size() const { return mapped ? mapped->get_size() : storage.get_size(); }
 
     // Expose cache content for inspection: returns copy of key list (unordered)
-    Sequence<int> get_cache_keys() const
+    KeyList get_cache_keys() const
     {
-        Sequence<int> keys;
+        KeyList keys;
+        keys.reserve(cache_map.size());
         for (const auto &p : cache_map)
             keys.push_back(p.first);
         return keys;
@@ -254,12 +313,12 @@ public:
     void clear()
     {
         cache_map.clear();
-        freq_lists.clear();
-        key_iter_map.clear();
-        key_freq_map.clear();
-        min_freq = 0;
+        policy.clear();
         storage.clear();
         all_data.clear();
+        mapped.reset();
+        if (l2)
+            l2->clear();
         stats = CacheStats();
     }
 };
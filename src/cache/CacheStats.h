@@ -6,13 +6,15 @@ struct CacheStats
     size_t misses;
     size_t total_accesses;
     size_t evictions;
+    size_t l2_hits;   // misses served by the disk tier
+    size_t l2_writes; // evictions spilled to the disk tier
     double hit_rate;
     double avg_access_time_cache;
     double avg_access_time_storage;
     double speedup;
 
     CacheStats() : hits(0), misses(0), total_accesses(0), evictions(0),
-                   hit_rate(0.0), avg_access_time_cache(0.0),
+                   l2_hits(0), l2_writes(0), hit_rate(0.0), avg_access_time_cache(0.0),
                    avg_access_time_storage(0.0), speedup(0.0) {}
 };
 
@@ -23,13 +25,14 @@ struct BenchmarkResult
     size_t data_size;
     size_t num_requests;
     double time_cache_total_ms;
-    double time_storage_total_ms;
+    double time_storage_total_ms; // direct-storage lookups only
+    double time_storage_build_ms; // loading the direct storage before them
     double speedup;
     size_t hits;
     size_t misses;
     double hit_rate;
 
     BenchmarkResult() : cache_size(0), data_size(0), num_requests(0),
-                        time_cache_total_ms(0.0), time_storage_total_ms(0.0),
+                        time_cache_total_ms(0.0), time_storage_total_ms(0.0), time_storage_build_ms(0.0),
                         speedup(0.0), hits(0), misses(0), hit_rate(0.0) {}
 };
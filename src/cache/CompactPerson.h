@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <functional>
+#include "Person.h"
+#include "StringPool.h"
+
+/**
+ * @brief Fixed-size, trivially copyable encoding of Person.
+ *
+ * Strings are replaced by 32-bit ids into a StringPool: `name` as a whole,
+ * `email` split into local part and domain so the (heavily repeated)
+ * domains are stored once. Comparison and hashing use `id`, like Person,
+ * so CompactPerson can be used directly as CacheManager / BTree payload.
+ * The string accessors take the pool the record was encoded with.
+ */
+struct CompactPerson
+{
+    int id;
+    int age;
+    uint32_t name_id;
+    uint32_t email_local_id;
+    uint32_t email_domain_id;
+
+    CompactPerson() : id(0), age(0), name_id(0), email_local_id(0), email_domain_id(0) {}
+    explicit CompactPerson(int id) : id(id), age(0), name_id(0), email_local_id(0), email_domain_id(0) {}
+
+    explicit CompactPerson(const Person &p, StringPool &pool)
+        : id(p.id), age(p.age), name_id(pool.intern(p.name)), email_local_id(0), email_domain_id(0)
+    {
+        std::string_view email(p.email);
+        size_t at = email.find('@');
+        if (at == std::string_view::npos)
+        {
+            email_local_id = pool.intern(email);
+        }
+        else
+        {
+            email_local_id = pool.intern(email.substr(0, at));
+            // domain keeps its '@' so "a@" and "a" decode differently
+            email_domain_id = pool.intern(email.substr(at));
+        }
+    }
+
+    std::string_view name(const StringPool &pool) const
+    {
+        return pool.view(name_id);
+    }
+
+    std::string email(const StringPool &pool) const
+    {
+        std::string result(pool.view(email_local_id));
+        result += pool.view(email_domain_id);
+        return result;
+    }
+
+    Person to_person(const StringPool &pool) const
+    {
+        return Person(id, std::string(name(pool)), age, email(pool));
+    }
+
+    bool operator<(const CompactPerson &other) const { return id < other.id; }
+    bool operator>(const CompactPerson &other) const { return id > other.id; }
+    bool operator==(const CompactPerson &other) const { return id == other.id; }
+    bool operator<=(const CompactPerson &other) const { return id <= other.id; }
+    bool operator>=(const CompactPerson &other) const { return id >= other.id; }
+    bool operator!=(const CompactPerson &other) const { return id != other.id; }
+};
+
+namespace std
+{
+    template <>
+    struct hash<CompactPerson>
+    {
+        size_t operator()(const CompactPerson &p) const
+        {
+            return hash<int>()(p.id);
+        }
+    };
+}
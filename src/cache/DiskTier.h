@@ -0,0 +1,372 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+#include <stdexcept>
+#include <filesystem>
+#include <atomic>
+#include "Person.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Byte encoding of a cached value for the disk tier.
+// Trivially copyable types are stored as-is; other types need a specialization.
+template <typename T>
+struct DiskCodec
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "DiskCodec<T> must be specialized for non-trivially-copyable types");
+
+    static void encode(const T &value, std::string &out)
+    {
+        out.assign(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static bool decode(const char *bytes, size_t len, T &out)
+    {
+        if (len != sizeof(T))
+            return false;
+        std::memcpy(&out, bytes, sizeof(T));
+        return true;
+    }
+};
+
+template <>
+struct DiskCodec<Person>
+{
+    static void encode(const Person &p, std::string &out)
+    {
+        uint32_t name_len = static_cast<uint32_t>(p.name.size());
+        uint32_t email_len = static_cast<uint32_t>(p.email.size());
+        out.clear();
+        out.append(reinterpret_cast<const char *>(&p.id), sizeof(p.id));
+        out.append(reinterpret_cast<const char *>(&p.age), sizeof(p.age));
+        out.append(reinterpret_cast<const char *>(&name_len), sizeof(name_len));
+        out.append(reinterpret_cast<const char *>(&email_len), sizeof(email_len));
+        out.append(p.name);
+        out.append(p.email);
+    }
+
+    static bool decode(const char *bytes, size_t len, Person &out)
+    {
+        const size_t header = 2 * sizeof(int) + 2 * sizeof(uint32_t);
+        if (len < header)
+            return false;
+        uint32_t name_len, email_len;
+        std::memcpy(&out.id, bytes, sizeof(int));
+        std::memcpy(&out.age, bytes + sizeof(int), sizeof(int));
+        std::memcpy(&name_len, bytes + 2 * sizeof(int), sizeof(uint32_t));
+        std::memcpy(&email_len, bytes + 2 * sizeof(int) + sizeof(uint32_t), sizeof(uint32_t));
+        if (header + name_len + email_len != len)
+            return false;
+        out.name.assign(bytes + header, name_len);
+        out.email.assign(bytes + header + name_len, email_len);
+        return true;
+    }
+};
+
+/**
+ * @brief Second (L2) cache tier for entries evicted from CacheManager.
+ *
+ * Values are appended to fixed-size, memory-mapped segment files
+ * (log-structured: records are never updated in place). An in-memory
+ * index maps key -> (segment, offset, length). Overwritten and promoted
+ * records become garbage; sealed segments whose live ratio drops below
+ * the threshold are compacted by re-appending their live records.
+ * When the segment limit is reached the oldest segment is dropped.
+ *
+ * Segment files are scratch data and are removed when the tier is destroyed.
+ * Their names carry the process id and a per-process instance number, so
+ * several tiers may share one directory.
+ * On platforms without mmap the tier is disabled (is_available() == false).
+ */
+template <typename T>
+class DiskTier
+{
+private:
+    struct RecordHeader
+    {
+        int key;
+        uint32_t length;
+    };
+
+    struct Location
+    {
+        size_t segment;
+        size_t offset; // offset of the payload (after header)
+        uint32_t length;
+    };
+
+    struct Segment
+    {
+        size_t id;
+        std::string path;
+        char *base;
+        size_t used;
+        size_t live_bytes;
+        int fd;
+
+        Segment() : id(0), base(nullptr), used(0), live_bytes(0), fd(-1) {}
+    };
+
+    std::string directory;
+    std::string file_prefix; // "segment_<pid>_<instance>_"
+    size_t segment_bytes;
+    size_t max_segments;
+    double compact_live_ratio;
+
+    std::vector<Segment> segments; // oldest first; back() is the active one
+    size_t next_segment_id;
+    std::unordered_map<int, Location> index;
+    std::string scratch;
+    size_t compactions;
+    size_t dropped_segments;
+    bool available;
+
+    static size_t record_size(uint32_t length) { return sizeof(RecordHeader) + length; }
+
+    static std::string make_file_prefix()
+    {
+        static std::atomic<size_t> instances(0);
+        long pid = 0;
+#ifndef _WIN32
+        pid = static_cast<long>(::getpid());
+#endif
+        return "segment_" + std::to_string(pid) + "_" + std::to_string(instances++) + "_";
+    }
+
+    size_t position_of(size_t segment_id) const
+    {
+        for (size_t i = 0; i < segments.size(); ++i)
+            if (segments[i].id == segment_id)
+                return i;
+        return segments.size();
+    }
+
+#ifndef _WIN32
+    bool open_segment()
+    {
+        Segment s;
+        s.id = next_segment_id++;
+        s.path = directory + "/" + file_prefix + std::to_string(s.id) + ".log";
+        // O_EXCL: never clobber a file that belongs to someone else
+        s.fd = ::open(s.path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (s.fd < 0)
+            return false;
+        if (::ftruncate(s.fd, static_cast<off_t>(segment_bytes)) != 0)
+        {
+            ::close(s.fd);
+            ::unlink(s.path.c_str());
+            return false;
+        }
+        void *p = ::mmap(nullptr, segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, s.fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close(s.fd);
+            ::unlink(s.path.c_str());
+            return false;
+        }
+        s.base = static_cast<char *>(p);
+        segments.push_back(s);
+        return true;
+    }
+
+    void close_segment(Segment &s)
+    {
+        if (s.base)
+            ::munmap(s.base, segment_bytes);
+        if (s.fd >= 0)
+            ::close(s.fd);
+        ::unlink(s.path.c_str());
+        s.base = nullptr;
+        s.fd = -1;
+    }
+#else
+    bool open_segment() { return false; }
+    void close_segment(Segment &) {}
+#endif
+
+    // drop every index entry pointing into the segment and release it
+    void drop_segment(size_t pos)
+    {
+        size_t id = segments[pos].id;
+        for (auto it = index.begin(); it != index.end();)
+        {
+            if (it->second.segment == id)
+                it = index.erase(it);
+            else
+                ++it;
+        }
+        close_segment(segments[pos]);
+        segments.erase(segments.begin() + pos);
+        dropped_segments++;
+    }
+
+    // append raw record bytes into the active segment, rolling it over if needed
+    bool append(int key, const char *bytes, uint32_t length)
+    {
+        size_t need = record_size(length);
+        if (need > segment_bytes)
+            return false;
+
+        if (segments.empty() || segments.back().used + need > segment_bytes)
+        {
+            if (segments.size() >= max_segments)
+                drop_segment(0);
+            if (!open_segment())
+                return false;
+        }
+
+        Segment &active = segments.back();
+        RecordHeader h{key, length};
+        std::memcpy(active.base + active.used, &h, sizeof(h));
+        std::memcpy(active.base + active.used + sizeof(h), bytes, length);
+
+        remove_from_index(key);
+        index[key] = Location{active.id, active.used + sizeof(h), length};
+        active.used += need;
+        active.live_bytes += need;
+        return true;
+    }
+
+    void remove_from_index(int key)
+    {
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        size_t pos = position_of(it->second.segment);
+        if (pos < segments.size())
+            segments[pos].live_bytes -= record_size(it->second.length);
+        index.erase(it);
+    }
+
+    // rewrite live records of a sealed segment into the active one
+    void compact(size_t pos)
+    {
+        Segment victim = segments[pos];
+        segments.erase(segments.begin() + pos);
+
+        size_t offset = 0;
+        while (offset + sizeof(RecordHeader) <= victim.used)
+        {
+            RecordHeader h;
+            std::memcpy(&h, victim.base + offset, sizeof(h));
+            size_t payload = offset + sizeof(h);
+            auto it = index.find(h.key);
+            if (it != index.end() && it->second.segment == victim.id && it->second.offset == payload)
+            {
+                index.erase(it);
+                if (!append(h.key, victim.base + payload, h.length))
+                    break;
+            }
+            offset = payload + h.length;
+        }
+
+        // anything left pointing into the victim could not be moved
+        for (auto it = index.begin(); it != index.end();)
+        {
+            if (it->second.segment == victim.id)
+                it = index.erase(it);
+            else
+                ++it;
+        }
+        close_segment(victim);
+        compactions++;
+    }
+
+    void maybe_compact()
+    {
+        // never compact the active segment
+        for (size_t i = 0; i + 1 < segments.size(); ++i)
+        {
+            const Segment &s = segments[i];
+            if (s.used > 0 && static_cast<double>(s.live_bytes) < compact_live_ratio * static_cast<double>(s.used))
+            {
+                compact(i);
+                return;
+            }
+        }
+    }
+
+public:
+    DiskTier(const std::string &dir, size_t segment_size = 1 << 20, size_t max_segment_count = 16,
+             double live_ratio = 0.5)
+        : directory(dir), file_prefix(make_file_prefix()), segment_bytes(segment_size), max_segments(max_segment_count),
+          compact_live_ratio(live_ratio), next_segment_id(0), compactions(0), dropped_segments(0),
+          available(false)
+    {
+        if (segment_bytes < sizeof(RecordHeader) || max_segments < 2)
+            throw std::invalid_argument("DiskTier: segment size too small or fewer than 2 segments");
+#ifndef _WIN32
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        available = !ec;
+#endif
+    }
+
+    ~DiskTier()
+    {
+        for (auto &s : segments)
+            close_segment(s);
+    }
+
+    DiskTier(const DiskTier &) = delete;
+    DiskTier &operator=(const DiskTier &) = delete;
+
+    bool is_available() const { return available; }
+
+    bool put(int key, const T &value)
+    {
+        if (!available)
+            return false;
+        DiskCodec<T>::encode(value, scratch);
+        bool ok = append(key, scratch.data(), static_cast<uint32_t>(scratch.size()));
+        if (ok)
+            maybe_compact();
+        return ok;
+    }
+
+    bool get(int key, T &out) const
+    {
+        auto it = index.find(key);
+        if (it == index.end())
+            return false;
+        size_t pos = position_of(it->second.segment);
+        if (pos >= segments.size())
+            return false;
+        return DiskCodec<T>::decode(segments[pos].base + it->second.offset, it->second.length, out);
+    }
+
+    bool contains(int key) const { return index.find(key) != index.end(); }
+
+    bool erase(int key)
+    {
+        if (index.find(key) == index.end())
+            return false;
+        remove_from_index(key);
+        maybe_compact();
+        return true;
+    }
+
+    void clear()
+    {
+        for (auto &s : segments)
+            close_segment(s);
+        segments.clear();
+        index.clear();
+    }
+
+    size_t get_size() const { return index.size(); }
+    size_t get_segment_count() const { return segments.size(); }
+    size_t get_compactions() const { return compactions; }
+    size_t get_dropped_segments() const { return dropped_segments; }
+};
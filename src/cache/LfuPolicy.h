@@ -0,0 +1,198 @@
+#pragma once
+
+#include <unordered_map>
+#include <list>
+#include <iostream>
+#include <algorithm>
+#include "../data_structures/Sequence.h"
+
+/**
+ * @brief LFU replacement bookkeeping (ties broken by LRU), independent of
+ * what is being cached. Used by CacheManager for records and by the paged
+ * B+tree buffer pool for pages.
+ */
+class LfuPolicy
+{
+private:
+    // frequency lists: freq -> list of keys with that freq (front: most-recent-with-this-freq)
+    std::unordered_map<size_t, std::list<int>> freq_lists;
+
+    // map key -> iterator in corresponding list (for O(1) removal)
+    std::unordered_map<int, std::list<int>::iterator> key_iter_map;
+
+    // map key -> current frequency
+    std::unordered_map<int, size_t> key_freq_map;
+
+    // minimal frequency currently tracked (to quickly evict LFU)
+    size_t min_freq;
+
+    void remove(int key, size_t freq)
+    {
+        auto list_it = freq_lists.find(freq);
+        list_it->second.erase(key_iter_map[key]);
+        if (list_it->second.empty())
+            freq_lists.erase(list_it);
+        key_iter_map.erase(key);
+        key_freq_map.erase(key);
+    }
+
+public:
+    LfuPolicy() : min_freq(0) {}
+
+    // start tracking a key with frequency 1
+    void insert(int key)
+    {
+        key_freq_map[key] = 1;
+        freq_lists[1].push_front(key);
+        key_iter_map[key] = freq_lists[1].begin();
+        min_freq = 1;
+    }
+
+    // register an access -> increase its frequency
+    void touch(int key)
+    {
+        auto itf = key_freq_map.find(key);
+        if (itf == key_freq_map.end())
+            return; // shouldn't happen
+
+        size_t freq = itf->second;
+        // remove from old freq list
+        auto &old_list = freq_lists[freq];
+        auto it_key_it = key_iter_map.find(key);
+        if (it_key_it != key_iter_map.end())
+            old_list.erase(it_key_it->second);
+
+        // if old list is empty and freq == min_freq, increment min_freq
+        if (old_list.empty())
+        {
+            if (freq == min_freq)
+                min_freq++;
+            // drop it so freq_lists only holds frequencies still in use
+            freq_lists.erase(freq);
+        }
+
+        // insert into new list with freq+1 at front (recently used)
+        size_t newf = freq + 1;
+        freq_lists[newf].push_front(key);
+        key_iter_map[key] = freq_lists[newf].begin();
+        key_freq_map[key] = newf;
+    }
+
+    // Remove and return the least frequently (then least recently) used key
+    bool pop_victim(int &victim_key)
+    {
+        if (key_freq_map.empty())
+            return false;
+        // find list for min_freq
+        auto it = freq_lists.find(min_freq);
+        if (it == freq_lists.end() || it->second.empty())
+        {
+            // find next non-empty freq
+            for (auto &p : freq_lists)
+            {
+                if (!p.second.empty())
+                {
+                    min_freq = p.first;
+                    break;
+                }
+            }
+            it = freq_lists.find(min_freq);
+            if (it == freq_lists.end() || it->second.empty())
+                return false;
+        }
+
+        // Evict the least recently used among those with min_freq -> take back()
+        victim_key = it->second.back();
+        it->second.pop_back();
+
+        key_iter_map.erase(victim_key);
+        key_freq_map.erase(victim_key);
+
+        // if the list became empty, erase it
+        if (it->second.empty())
+            freq_lists.erase(it);
+        return true;
+    }
+
+    // Same order as pop_victim, skipping keys for which can_evict(key) is false
+    template <typename Pred>
+    bool pop_victim_if(int &victim_key, Pred can_evict)
+    {
+        // common case: an evictable key at the minimal frequency
+        auto min_it = freq_lists.find(min_freq);
+        if (min_it != freq_lists.end())
+        {
+            for (auto it = min_it->second.rbegin(); it != min_it->second.rend(); ++it)
+            {
+                if (can_evict(*it))
+                {
+                    victim_key = *it;
+                    remove(victim_key, min_freq);
+                    return true;
+                }
+            }
+        }
+
+        // otherwise walk the remaining frequencies in increasing order
+        Sequence<size_t> freqs;
+        for (auto &p : freq_lists)
+            if (p.first != min_freq)
+                freqs.push_back(p.first);
+        std::sort(freqs.begin(), freqs.end());
+
+        for (size_t f : freqs)
+        {
+            const std::list<int> &keys = freq_lists[f];
+            for (auto it = keys.rbegin(); it != keys.rend(); ++it)
+            {
+                if (can_evict(*it))
+                {
+                    victim_key = *it;
+                    remove(victim_key, f);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // stop tracking a key
+    void erase(int key)
+    {
+        auto itf = key_freq_map.find(key);
+        if (itf != key_freq_map.end())
+            remove(key, itf->second);
+    }
+
+    bool contains(int key) const { return key_freq_map.find(key) != key_freq_map.end(); }
+
+    size_t frequency(int key) const
+    {
+        auto itf = key_freq_map.find(key);
+        return itf == key_freq_map.end() ? 0 : itf->second;
+    }
+
+    size_t get_size() const { return key_freq_map.size(); }
+
+    void clear()
+    {
+        freq_lists.clear();
+        key_iter_map.clear();
+        key_freq_map.clear();
+        min_freq = 0;
+    }
+
+    void dump(std::ostream &os) const
+    {
+        for (auto &p : freq_lists)
+        {
+            size_t freq = p.first;
+            os << "freq " << freq << ": ";
+
+            for (int k : p.second)
+                os << k << " ";
+            os << "\n";
+        }
+        os << "min_freq = " << min_freq << "\n";
+    }
+};
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "../data_structures/BTree.h"
+#include "../data_structures/EytzingerIndex.h"
+#include "../data_structures/Sequence.h"
+
+// Distribution of simulated per-request latency, in microseconds
+struct LatencyModel
+{
+    enum class Kind
+    {
+        None,
+        Constant,
+        LogNormal,
+        Bimodal
+    };
+
+    Kind kind;
+    double a;        // constant: latency; lognormal: median; bimodal: fast latency
+    double b;        // lognormal: sigma; bimodal: slow latency
+    double fraction; // bimodal: share of slow requests
+
+    LatencyModel() : kind(Kind::None), a(0.0), b(0.0), fraction(0.0) {}
+
+    static LatencyModel none() { return LatencyModel(); }
+
+    static LatencyModel constant(double us)
+    {
+        LatencyModel m;
+        m.kind = Kind::Constant;
+        m.a = us;
+        return m;
+    }
+
+    // Heavy right tail: median `median_us`, spread `sigma` (log space)
+    static LatencyModel lognormal(double median_us, double sigma)
+    {
+        if (median_us <= 0.0 || sigma < 0.0)
+            throw std::invalid_argument("lognormal latency needs median > 0 and sigma >= 0");
+        LatencyModel m;
+        m.kind = Kind::LogNormal;
+        m.a = median_us;
+        m.b = sigma;
+        return m;
+    }
+
+    // Mostly fast requests with a `slow_fraction` share of slow ones (e.g. cache vs disk)
+    static LatencyModel bimodal(double fast_us, double slow_us, double slow_fraction)
+    {
+        if (slow_fraction < 0.0 || slow_fraction > 1.0)
+            throw std::invalid_argument("bimodal slow_fraction must be in [0, 1]");
+        LatencyModel m;
+        m.kind = Kind::Bimodal;
+        m.a = fast_us;
+        m.b = slow_us;
+        m.fraction = slow_fraction;
+        return m;
+    }
+
+    template <typename Gen>
+    double sample(Gen &gen) const
+    {
+        switch (kind)
+        {
+        case Kind::Constant:
+            return a;
+        case Kind::LogNormal:
+            return std::lognormal_distribution<double>(std::log(a), b)(gen);
+        case Kind::Bimodal:
+            return std::uniform_real_distribution<double>(0.0, 1.0)(gen) < fraction ? b : a;
+        default:
+            return 0.0;
+        }
+    }
+};
+
+// How a simulated request waits: sleep frees the core, spin burns it (more precise for short waits)
+enum class WaitMode
+{
+    Sleep,
+    Spin
+};
+
+// Lookup structure behind SlowStorage: mutable BTree or read-only Eytzinger array
+enum class StorageIndex
+{
+    BTree,
+    Eytzinger
+};
+
+struct SlowStorageStats
+{
+    size_t requests;
+    double total_latency_us; // simulated service time
+    double total_queue_us;   // time spent waiting for a free slot
+    size_t max_in_flight;
+
+    SlowStorageStats() : requests(0), total_latency_us(0.0), total_queue_us(0.0), max_in_flight(0) {}
+};
+
+/**
+ * @brief Simulated slow backend: an index behind a latency model.
+ *
+ * The index is a BTree by default; StorageIndex::Eytzinger swaps in an
+ * immutable EytzingerIndex, which is faster to search but read-only
+ * (insert() then throws logic_error; reload with load()).
+ *
+ * Every search pays a latency drawn from `LatencyModel`. At most
+ * `queue_depth` requests are served at once; further callers queue until
+ * a slot frees, so concurrent loaders see queueing delay as well.
+ * With LatencyModel::none() it behaves like the bare BTree.
+ */
+template <typename T>
+class SlowStorage
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    StorageIndex index_kind;
+    BTree<T> tree;
+    EytzingerIndex<T> eytzinger;
+    LatencyModel model;
+    WaitMode mode;
+    size_t queue_depth;
+
+    mutable std::mutex mtx;
+    std::condition_variable slot_freed;
+    size_t in_flight;
+    std::mt19937_64 gen;
+    SlowStorageStats stats;
+
+    static void wait_for(double us, WaitMode how)
+    {
+        if (us <= 0.0)
+            return;
+        auto deadline = Clock::now() + std::chrono::nanoseconds(static_cast<long long>(us * 1000.0));
+        if (how == WaitMode::Sleep)
+            std::this_thread::sleep_until(deadline);
+        else
+            while (Clock::now() < deadline)
+            {
+            }
+    }
+
+public:
+    explicit SlowStorage(const LatencyModel &latency = LatencyModel::none(), size_t max_in_flight = 1,
+                         WaitMode wait_mode = WaitMode::Spin, unsigned seed = 12345)
+        : index_kind(StorageIndex::BTree), model(latency), mode(wait_mode), queue_depth(max_in_flight), in_flight(0), gen(seed)
+    {
+        if (queue_depth == 0)
+            throw std::invalid_argument("SlowStorage queue depth must be > 0");
+    }
+
+    SlowStorage(const SlowStorage &) = delete;
+    SlowStorage &operator=(const SlowStorage &) = delete;
+
+    void configure(const LatencyModel &latency, size_t max_in_flight = 1, WaitMode wait_mode = WaitMode::Spin)
+    {
+        if (max_in_flight == 0)
+            throw std::invalid_argument("SlowStorage queue depth must be > 0");
+        std::lock_guard<std::mutex> lock(mtx);
+        model = latency;
+        queue_depth = max_in_flight;
+        mode = wait_mode;
+    }
+
+    // Pay the cost of one request without a lookup (record fetched by position)
+    void access()
+    {
+        auto queued_at = Clock::now();
+        double latency;
+        WaitMode how;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (model.kind == LatencyModel::Kind::None)
+            {
+                stats.requests++;
+                return;
+            }
+            slot_freed.wait(lock, [this]
+                            { return in_flight < queue_depth; });
+            in_flight++;
+            if (in_flight > stats.max_in_flight)
+                stats.max_in_flight = in_flight;
+            latency = model.sample(gen);
+            how = mode;
+            stats.requests++;
+            stats.total_latency_us += latency;
+            stats.total_queue_us += std::chrono::duration<double, std::micro>(Clock::now() - queued_at).count();
+        }
+
+        wait_for(latency, how);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            in_flight--;
+        }
+        slot_freed.notify_one();
+    }
+
+    // Choose the index used by the next load(); drops the current contents
+    void set_index(StorageIndex kind)
+    {
+        clear();
+        index_kind = kind;
+    }
+
+    StorageIndex get_index() const { return index_kind; }
+
+    T *search(const T &key)
+    {
+        access();
+        return index_kind == StorageIndex::Eytzinger ? eytzinger.search(key) : tree.search(key);
+    }
+
+    bool contains(const T &key)
+    {
+        return search(key) != nullptr;
+    }
+
+    // Loading is not charged: it models data already sitting in storage
+    void load(const Sequence<T> &data)
+    {
+        if (index_kind == StorageIndex::Eytzinger)
+        {
+            if (BTree<T>::is_sorted(data))
+                eytzinger.build(data);
+            else
+            {
+                Sequence<T> sorted = data;
+                std::sort(sorted.begin(), sorted.end());
+                eytzinger.build(sorted);
+            }
+        }
+        else if (BTree<T>::is_sorted(data))
+            tree.bulk_load(data);
+        else
+        {
+            tree.clear();
+            for (size_t i = 0; i < data.get_size(); ++i)
+                tree.insert(data[i]);
+        }
+    }
+
+    void insert(const T &value)
+    {
+        if (index_kind == StorageIndex::Eytzinger)
+            throw std::logic_error("SlowStorage: Eytzinger index is read-only");
+        tree.insert(value);
+    }
+
+    void clear()
+    {
+        tree.clear();
+        eytzinger.clear();
+    }
+
+    size_t get_size() const { return index_kind == StorageIndex::Eytzinger ? eytzinger.get_size() : tree.get_size(); }
+
+    SlowStorageStats get_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+
+    void reset_statistics()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stats = SlowStorageStats();
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+
+/**
+ * @brief Interned string storage with 32-bit ids.
+ *
+ * Every distinct string is stored once in an append-only arena of
+ * fixed-size chunks, so views handed out stay valid for the pool's
+ * lifetime. Id 0 is always the empty string.
+ */
+class StringPool
+{
+private:
+    struct Slice
+    {
+        const char *ptr;
+        uint32_t length;
+    };
+
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunk_used;
+    size_t arena_bytes;
+    std::vector<Slice> slices;
+    std::unordered_map<std::string_view, uint32_t> lookup;
+
+    const char *store(std::string_view s)
+    {
+        if (s.empty())
+            return "";
+
+        if (s.size() > CHUNK_SIZE)
+        {
+            // oversized strings get a dedicated chunk; the current chunk stays last
+            std::unique_ptr<char[]> big(new char[s.size()]);
+            std::memcpy(big.get(), s.data(), s.size());
+            arena_bytes += s.size();
+            const char *p = big.get();
+            if (chunks.empty())
+            {
+                chunks.push_back(std::move(big));
+                chunk_used = CHUNK_SIZE;
+            }
+            else
+                chunks.insert(chunks.end() - 1, std::move(big));
+            return p;
+        }
+
+        if (chunks.empty() || chunk_used + s.size() > CHUNK_SIZE)
+        {
+            chunks.emplace_back(new char[CHUNK_SIZE]);
+            chunk_used = 0;
+            arena_bytes += CHUNK_SIZE;
+        }
+        char *dst = chunks.back().get() + chunk_used;
+        std::memcpy(dst, s.data(), s.size());
+        chunk_used += s.size();
+        return dst;
+    }
+
+public:
+    StringPool() : chunk_used(0), arena_bytes(0)
+    {
+        slices.push_back(Slice{"", 0});
+        lookup.emplace(std::string_view(), 0);
+    }
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    uint32_t intern(std::string_view s)
+    {
+        auto it = lookup.find(s);
+        if (it != lookup.end())
+            return it->second;
+
+        if (slices.size() >= UINT32_MAX)
+            throw std::overflow_error("StringPool: id space exhausted");
+
+        const char *p = store(s);
+        uint32_t id = static_cast<uint32_t>(slices.size());
+        slices.push_back(Slice{p, static_cast<uint32_t>(s.size())});
+        lookup.emplace(std::string_view(p, s.size()), id);
+        return id;
+    }
+
+    std::string_view view(uint32_t id) const
+    {
+        if (id >= slices.size())
+            throw std::out_of_range("StringPool: unknown id");
+        return std::string_view(slices[id].ptr, slices[id].length);
+    }
+
+    size_t get_size() const { return slices.size(); }
+
+    // Approximate heap footprint: arena + id table + hash index
+    size_t bytes_used() const
+    {
+        size_t node_bytes = sizeof(void *) + sizeof(std::string_view) + sizeof(uint32_t) + sizeof(size_t);
+        return arena_bytes + slices.capacity() * sizeof(Slice) + lookup.size() * node_bytes +
+               lookup.bucket_count() * sizeof(void *);
+    }
+};
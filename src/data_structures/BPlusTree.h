@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Cache-conscious B+tree with node size fixed at compile time.
+ *
+ * Keys (and leaf values) are stored inline in fixed arrays sized so one
+ * node fills NODE_BYTES (a multiple of the 64-byte cache line). Inner nodes
+ * hold only separator keys and child pointers; values live in the leaves,
+ * which are linked left to right. For `int` keys the in-node search is a
+ * branch-free SIMD count (AVX2 / SSE2), otherwise a scalar scan.
+ * Insertion is iterative: the descent path is kept in a small fixed stack.
+ */
+template <typename K, typename V, size_t NODE_BYTES = 256>
+class BPlusTree
+{
+    static_assert(NODE_BYTES % 64 == 0, "NODE_BYTES must be a multiple of the cache line size");
+
+private:
+    static constexpr size_t HEADER = 16;
+    static constexpr size_t inner_fit = (NODE_BYTES - HEADER - sizeof(void *)) / (sizeof(K) + sizeof(void *));
+    static constexpr size_t leaf_fit = (NODE_BYTES - HEADER - sizeof(void *)) / (sizeof(K) + sizeof(V));
+    static constexpr size_t MAX_DEPTH = 48;
+
+public:
+    static constexpr size_t INNER_CAPACITY = inner_fit < 3 ? 3 : inner_fit;
+    static constexpr size_t LEAF_CAPACITY = leaf_fit < 3 ? 3 : leaf_fit;
+
+private:
+    struct Node
+    {
+        uint32_t count;
+        bool is_leaf;
+
+        explicit Node(bool leaf) : count(0), is_leaf(leaf) {}
+    };
+
+    struct alignas(64) Inner : Node
+    {
+        K keys[INNER_CAPACITY];
+        Node *children[INNER_CAPACITY + 1];
+
+        Inner() : Node(false) {}
+    };
+
+    struct alignas(64) Leaf : Node
+    {
+        K keys[LEAF_CAPACITY];
+        V values[LEAF_CAPACITY];
+        Leaf *next;
+
+        Leaf() : Node(true), next(nullptr) {}
+    };
+
+    Node *root;
+    size_t size;
+    size_t height;
+    size_t inner_count;
+    size_t leaf_count;
+
+    // number of keys in keys[0..n) that are <= key (inner) or < key (leaf)
+    template <bool INCLUSIVE>
+    static size_t count_less(const K *keys, size_t n, const K &key)
+    {
+        size_t i = 0;
+        size_t result = 0;
+        if constexpr (std::is_same<K, int>::value)
+        {
+            // keys < key  <=>  keys <= key - 1; nothing is below INT32_MIN
+            if (!INCLUSIVE && key == INT32_MIN)
+                return 0;
+            const int bound = INCLUSIVE ? key : key - 1;
+#if defined(__AVX2__)
+            const __m256i needle = _mm256_set1_epi32(bound);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+                __m256i gt = _mm256_cmpgt_epi32(block, needle);
+                result += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+            }
+#endif
+#if defined(__SSE2__)
+            const __m128i needle4 = _mm_set1_epi32(bound);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+                __m128i gt = _mm_cmpgt_epi32(block, needle4);
+                result += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(gt)));
+            }
+#endif
+            (void)bound;
+        }
+        for (; i < n; ++i)
+            result += INCLUSIVE ? !(key < keys[i]) : (keys[i] < key);
+        return result;
+    }
+
+    static size_t child_index(const Inner *node, const K &key)
+    {
+        return count_less<true>(node->keys, node->count, key);
+    }
+
+    static size_t leaf_index(const Leaf *leaf, const K &key)
+    {
+        return count_less<false>(leaf->keys, leaf->count, key);
+    }
+
+    Leaf *find_leaf(const K &key) const
+    {
+        Node *n = root;
+        while (!n->is_leaf)
+        {
+            const Inner *in = static_cast<const Inner *>(n);
+            n = in->children[child_index(in, key)];
+        }
+        return static_cast<Leaf *>(n);
+    }
+
+    void destroy(Node *n)
+    {
+        if (!n->is_leaf)
+        {
+            Inner *in = static_cast<Inner *>(n);
+            for (size_t i = 0; i <= in->count; ++i)
+                destroy(in->children[i]);
+            delete in;
+        }
+        else
+            delete static_cast<Leaf *>(n);
+    }
+
+public:
+    // Forward iterator over the linked leaves, optionally stopping after `hi`
+    class const_iterator
+    {
+    private:
+        const Leaf *leaf;
+        size_t idx;
+        bool bounded;
+        K hi;
+
+        void settle()
+        {
+            while (leaf && idx >= leaf->count)
+            {
+                leaf = leaf->next;
+                idx = 0;
+            }
+            if (leaf && bounded && hi < leaf->keys[idx])
+                leaf = nullptr;
+        }
+
+        friend class BPlusTree;
+
+    public:
+        const_iterator() : leaf(nullptr), idx(0), bounded(false), hi() {}
+
+        const K &key() const { return leaf->keys[idx]; }
+        const V &value() const { return leaf->values[idx]; }
+
+        const_iterator &operator++()
+        {
+            idx++;
+            settle();
+            return *this;
+        }
+
+        bool at_end() const { return leaf == nullptr; }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return leaf == other.leaf && (leaf == nullptr || idx == other.idx);
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    BPlusTree() : root(new Leaf()), size(0), height(1), inner_count(0), leaf_count(1) {}
+
+    ~BPlusTree()
+    {
+        destroy(root);
+    }
+
+    BPlusTree(const BPlusTree &) = delete;
+    BPlusTree &operator=(const BPlusTree &) = delete;
+
+    // Insert or overwrite
+    void insert(const K &key, const V &value)
+    {
+        Inner *path[MAX_DEPTH];
+        size_t slots[MAX_DEPTH];
+        size_t depth = 0;
+
+        Node *n = root;
+        while (!n->is_leaf)
+        {
+            Inner *in = static_cast<Inner *>(n);
+            size_t c = child_index(in, key);
+            path[depth] = in;
+            slots[depth] = c;
+            depth++;
+            n = in->children[c];
+        }
+
+        Leaf *leaf = static_cast<Leaf *>(n);
+        size_t pos = leaf_index(leaf, key);
+        if (pos < leaf->count && leaf->keys[pos] == key)
+        {
+            leaf->values[pos] = value;
+            return;
+        }
+
+        size++;
+        if (leaf->count < LEAF_CAPACITY)
+        {
+            for (size_t j = leaf->count; j > pos; --j)
+            {
+                leaf->keys[j] = leaf->keys[j - 1];
+                leaf->values[j] = leaf->values[j - 1];
+            }
+            leaf->keys[pos] = key;
+            leaf->values[pos] = value;
+            leaf->count++;
+            return;
+        }
+
+        // split the full leaf: left keeps `half`, right gets the rest (incl. new key)
+        Leaf *right = new Leaf();
+        leaf_count++;
+        const size_t total = LEAF_CAPACITY + 1;
+        const size_t half = total / 2;
+        for (size_t src = total; src-- > 0;)
+        {
+            // src indexes the virtual merged array of LEAF_CAPACITY + 1 entries
+            const K &k = src == pos ? key : leaf->keys[src > pos ? src - 1 : src];
+            const V &v = src == pos ? value : leaf->values[src > pos ? src - 1 : src];
+            if (src >= half)
+            {
+                right->keys[src - half] = k;
+                right->values[src - half] = v;
+            }
+            else
+            {
+                leaf->keys[src] = k;
+                leaf->values[src] = v;
+            }
+        }
+        leaf->count = static_cast<uint32_t>(half);
+        right->count = static_cast<uint32_t>(total - half);
+        right->next = leaf->next;
+        leaf->next = right;
+
+        K separator = right->keys[0];
+        Node *new_child = right;
+
+        // propagate the split upwards
+        while (depth > 0)
+        {
+            depth--;
+            Inner *parent = path[depth];
+            size_t c = slots[depth];
+
+            if (parent->count < INNER_CAPACITY)
+            {
+                for (size_t j = parent->count; j > c; --j)
+                {
+                    parent->keys[j] = parent->keys[j - 1];
+                    parent->children[j + 1] = parent->children[j];
+                }
+                parent->keys[c] = separator;
+                parent->children[c + 1] = new_child;
+                parent->count++;
+                return;
+            }
+
+            // split a full inner node around the middle key of INNER_CAPACITY + 1 keys
+            K keys[INNER_CAPACITY + 1];
+            Node *kids[INNER_CAPACITY + 2];
+            for (size_t j = 0, s = 0; j <= INNER_CAPACITY; ++j)
+                keys[j] = j == c ? separator : parent->keys[s++];
+            for (size_t j = 0, s = 0; j <= INNER_CAPACITY + 1; ++j)
+                kids[j] = j == c + 1 ? new_child : parent->children[s++];
+
+            const size_t mid = (INNER_CAPACITY + 1) / 2;
+            Inner *sibling = new Inner();
+            inner_count++;
+
+            parent->count = static_cast<uint32_t>(mid);
+            for (size_t j = 0; j < mid; ++j)
+            {
+                parent->keys[j] = keys[j];
+                parent->children[j] = kids[j];
+            }
+            parent->children[mid] = kids[mid];
+
+            sibling->count = static_cast<uint32_t>(INNER_CAPACITY - mid);
+            for (size_t j = 0; j < sibling->count; ++j)
+            {
+                sibling->keys[j] = keys[mid + 1 + j];
+                sibling->children[j] = kids[mid + 1 + j];
+            }
+            sibling->children[sibling->count] = kids[INNER_CAPACITY + 1];
+
+            separator = keys[mid];
+            new_child = sibling;
+        }
+
+        // root was split
+        if (height + 1 > MAX_DEPTH)
+            throw std::length_error("BPlusTree: maximum depth exceeded");
+        Inner *new_root = new Inner();
+        inner_count++;
+        new_root->count = 1;
+        new_root->keys[0] = separator;
+        new_root->children[0] = root;
+        new_root->children[1] = new_child;
+        root = new_root;
+        height++;
+    }
+
+    V *find(const K &key) const
+    {
+        Leaf *leaf = find_leaf(key);
+        size_t pos = leaf_index(leaf, key);
+        if (pos < leaf->count && leaf->keys[pos] == key)
+            return &leaf->values[pos];
+        return nullptr;
+    }
+
+    bool contains(const K &key) const { return find(key) != nullptr; }
+
+    const_iterator begin() const
+    {
+        Node *n = root;
+        while (!n->is_leaf)
+            n = static_cast<Inner *>(n)->children[0];
+        const_iterator it;
+        it.leaf = static_cast<Leaf *>(n);
+        it.settle();
+        return it;
+    }
+
+    const_iterator end() const { return const_iterator(); }
+
+    // first entry with key >= `key`
+    const_iterator lower_bound(const K &key) const
+    {
+        const_iterator it;
+        it.leaf = find_leaf(key);
+        it.idx = leaf_index(it.leaf, key);
+        it.settle();
+        return it;
+    }
+
+    // entries with lo <= key <= hi, in key order
+    const_iterator range(const K &lo, const K &hi) const
+    {
+        const_iterator it;
+        it.bounded = true;
+        it.hi = hi;
+        it.leaf = find_leaf(lo);
+        it.idx = leaf_index(it.leaf, lo);
+        it.settle();
+        return it;
+    }
+
+    void clear()
+    {
+        destroy(root);
+        root = new Leaf();
+        size = 0;
+        height = 1;
+        inner_count = 0;
+        leaf_count = 1;
+    }
+
+    size_t get_size() const { return size; }
+    size_t get_height() const { return height; }
+    size_t get_node_count() const { return inner_count + leaf_count; }
+    size_t memory_bytes() const { return inner_count * sizeof(Inner) + leaf_count * sizeof(Leaf); }
+};
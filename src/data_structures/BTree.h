@@ -1,7 +1,10 @@
 #pragma once
 #include "Sequence.h"
+#include "InlineArray.h"
+#include "NodePool.h"
 #include <chrono>
 #include <stdexcept>
+#include <algorithm>
 
 template <typename T>
 class BTree
@@ -9,27 +12,37 @@ class BTree
 private:
     static constexpr int ORDER = 4;
 
+    // Ключи и дети хранятся прямо в узле: ORDER - 1 ключей и ORDER детей
     struct BNode
     {
-        Sequence<T> keys;           // ключи
-        Sequence<BNode *> children; // дети
+        InlineArray<T, ORDER - 1> keys;       // ключи
+        InlineArray<BNode *, ORDER> children; // дети
         bool is_leaf;
 
         BNode(bool leaf = true) : is_leaf(leaf) {}
-
-        ~BNode()
-        {
-            if (!is_leaf)
-            {
-                for (size_t i = 0; i < children.get_size(); ++i)
-                    delete children[i];
-            }
-        }
     };
 
+    NodePool<BNode> pool;
     BNode *root;
     size_t size;
 
+    // Освобождение всех узлов без рекурсии
+    void destroy_all()
+    {
+        Sequence<BNode *> stack;
+        stack.push_back(root);
+        while (!stack.is_empty())
+        {
+            BNode *node = stack[stack.get_size() - 1];
+            stack.pop_back();
+            if (!node->is_leaf)
+                for (size_t i = 0; i < node->children.get_size(); ++i)
+                    stack.push_back(node->children[i]);
+            pool.destroy(node);
+        }
+        root = nullptr;
+    }
+
     // Поиск ключа
     BNode *search_node(BNode *node, const T &key, size_t &idx) const
     {
@@ -53,7 +66,7 @@ private:
     void split_child(BNode *parent, int i)
     {
         BNode *full = parent->children[i];
-        BNode *new_child = new BNode(full->is_leaf);
+        BNode *new_child = pool.create(full->is_leaf);
 
         int t = ORDER / 2; // =2
 
@@ -120,22 +133,174 @@ private:
         }
     }
 
+    // Слияние children[i], keys[i] и children[i + 1] в children[i]
+    void merge_children(BNode *parent, size_t i)
+    {
+        BNode *left = parent->children[i];
+        BNode *right = parent->children[i + 1];
+
+        left->keys.push_back(parent->keys[i]);
+        for (size_t j = 0; j < right->keys.get_size(); ++j)
+            left->keys.push_back(right->keys[j]);
+        if (!left->is_leaf)
+        {
+            for (size_t j = 0; j < right->children.get_size(); ++j)
+                left->children.push_back(right->children[j]);
+            right->children.clear(); // дети теперь у left
+        }
+
+        parent->keys.erase(i);
+        parent->children.erase(i + 1);
+        pool.destroy(right);
+    }
+
+    // Перенос ключа из левого соседа через родителя
+    void borrow_from_left(BNode *parent, size_t i)
+    {
+        BNode *child = parent->children[i];
+        BNode *sibling = parent->children[i - 1];
+
+        child->keys.insert(0, parent->keys[i - 1]);
+        parent->keys[i - 1] = sibling->keys[sibling->keys.get_size() - 1];
+        sibling->keys.pop_back();
+        if (!child->is_leaf)
+        {
+            child->children.insert(0, sibling->children[sibling->children.get_size() - 1]);
+            sibling->children.pop_back();
+        }
+    }
+
+    // Перенос ключа из правого соседа через родителя
+    void borrow_from_right(BNode *parent, size_t i)
+    {
+        BNode *child = parent->children[i];
+        BNode *sibling = parent->children[i + 1];
+
+        child->keys.push_back(parent->keys[i]);
+        parent->keys[i] = sibling->keys[0];
+        sibling->keys.erase(0);
+        if (!child->is_leaf)
+        {
+            child->children.push_back(sibling->children[0]);
+            sibling->children.erase(0);
+        }
+    }
+
 public:
+    // Упорядоченный обход без аллокаций: явный стек (узел, индекс следующего ключа).
+    // Необязательная верхняя граница hi завершает обход после последнего ключа <= hi.
+    class const_iterator
+    {
+    private:
+        static constexpr size_t MAX_DEPTH = 64;
+
+        struct Frame
+        {
+            const BNode *node;
+            size_t idx;
+        };
+
+        Frame stack[MAX_DEPTH];
+        size_t depth;
+        bool bounded;
+        T hi; // по значению: итератор может пережить Range, из которого получен
+
+        void push(const BNode *node, size_t idx)
+        {
+            if (depth == MAX_DEPTH)
+                throw std::length_error("BTree iterator: tree too deep");
+            stack[depth++] = Frame{node, idx};
+        }
+
+        // спуск к самому левому ключу поддерева
+        void push_left(const BNode *node)
+        {
+            while (true)
+            {
+                push(node, 0);
+                if (node->is_leaf)
+                    break;
+                node = node->children[0];
+            }
+        }
+
+        // снять исчерпанные кадры и проверить верхнюю границу
+        void settle()
+        {
+            while (depth > 0 && stack[depth - 1].idx >= stack[depth - 1].node->keys.get_size())
+                depth--;
+            if (depth > 0 && bounded && hi < stack[depth - 1].node->keys[stack[depth - 1].idx])
+                depth = 0;
+        }
+
+        friend class BTree;
+        friend class Range;
+
+    public:
+        const_iterator() : depth(0), bounded(false), hi() {}
+
+        const T &operator*() const { return stack[depth - 1].node->keys[stack[depth - 1].idx]; }
+        const T *operator->() const { return &**this; }
+
+        const_iterator &operator++()
+        {
+            Frame &top = stack[depth - 1];
+            top.idx++;
+            if (!top.node->is_leaf)
+                push_left(top.node->children[top.idx]);
+            settle();
+            return *this;
+        }
+
+        bool at_end() const { return depth == 0; }
+
+        bool operator==(const const_iterator &other) const
+        {
+            if (depth == 0 || other.depth == 0)
+                return depth == other.depth;
+            return stack[depth - 1].node == other.stack[other.depth - 1].node &&
+                   stack[depth - 1].idx == other.stack[other.depth - 1].idx;
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    // Диапазон [lo, hi] для range-for
+    class Range
+    {
+    private:
+        const BTree *tree;
+        T lo;
+        T hi;
+
+    public:
+        Range(const BTree *t, const T &l, const T &h) : tree(t), lo(l), hi(h) {}
+
+        const_iterator begin() const
+        {
+            const_iterator it = tree->lower_bound(lo);
+            it.bounded = true;
+            it.hi = hi;
+            it.settle();
+            return it;
+        }
+        const_iterator end() const { return const_iterator(); }
+    };
+
     BTree() : size(0)
     {
-        root = new BNode(true);
+        root = pool.create(true);
     }
 
     ~BTree()
     {
-        clear();
+        destroy_all();
     }
 
     void insert(const T &key)
     {
         if (root->keys.get_size() == ORDER - 1)
         {
-            BNode *new_root = new BNode(false);
+            BNode *new_root = pool.create(false);
             new_root->children.push_back(root);
 
             split_child(new_root, 0);
@@ -146,6 +311,178 @@ public:
         size++;
     }
 
+    // Проверка сортировки (неубывание) — условие для bulk_load
+    static bool is_sorted(const Sequence<T> &data)
+    {
+        for (size_t i = 1; i < data.get_size(); ++i)
+        {
+            if (data[i] < data[i - 1])
+                return false;
+        }
+        return true;
+    }
+
+    // Построение дерева снизу вверх из отсортированной последовательности за O(n).
+    // fill_factor задаёт заполненность узлов (1.0 — максимально плотные узлы).
+    void bulk_load(const Sequence<T> &data, double fill_factor = 1.0)
+    {
+        if (fill_factor <= 0.0 || fill_factor > 1.0)
+            throw std::invalid_argument("fill_factor must be in (0, 1]");
+        if (!is_sorted(data))
+            throw std::invalid_argument("bulk_load requires sorted input");
+
+        clear();
+        size_t n = data.get_size();
+        if (n == 0)
+            return;
+
+        size_t leaf_keys = std::clamp<size_t>(static_cast<size_t>(fill_factor * (ORDER - 1) + 0.5), 1, ORDER - 1);
+        size_t fanout = std::clamp<size_t>(static_cast<size_t>(fill_factor * ORDER + 0.5), 2, ORDER);
+
+        // листья: m листьев, между соседними — один ключ-разделитель для родителя
+        size_t m = (n + 1 + leaf_keys) / (leaf_keys + 1);
+        m = std::max<size_t>(1, std::min(m, (n + 1) / 2));
+        size_t in_leaves = n - (m - 1);
+
+        Sequence<BNode *> level;
+        Sequence<T> separators;
+        size_t pos = 0;
+        for (size_t j = 0; j < m; ++j)
+        {
+            BNode *leaf = pool.create(true);
+            size_t cnt = in_leaves / m + (j < in_leaves % m ? 1 : 0);
+            for (size_t k = 0; k < cnt; ++k)
+                leaf->keys.push_back(data[pos++]);
+            level.push_back(leaf);
+            if (j + 1 < m)
+                separators.push_back(data[pos++]);
+        }
+
+        // внутренние уровни: группируем детей, между группами поднимаем разделитель
+        while (level.get_size() > 1)
+        {
+            size_t count = level.get_size();
+            size_t parents = (count + fanout - 1) / fanout;
+            parents = std::max<size_t>(1, std::min(parents, count / 2));
+
+            Sequence<BNode *> next_level;
+            Sequence<T> next_separators;
+            size_t child = 0;
+            for (size_t j = 0; j < parents; ++j)
+            {
+                BNode *node = pool.create(false);
+                size_t cnt = count / parents + (j < count % parents ? 1 : 0);
+                for (size_t k = 0; k < cnt; ++k)
+                {
+                    node->children.push_back(level[child]);
+                    if (k + 1 < cnt)
+                        node->keys.push_back(separators[child]);
+                    child++;
+                }
+                next_level.push_back(node);
+                if (j + 1 < parents)
+                    next_separators.push_back(separators[child - 1]);
+            }
+
+            level = std::move(next_level);
+            separators = std::move(next_separators);
+        }
+
+        pool.destroy(root);
+        root = level[0];
+        size = n;
+    }
+
+    // Удаление ключа за один проход сверху вниз (без рекурсии).
+    // Перед спуском в ребёнка с минимумом ключей он пополняется заимствованием
+    // у соседа или слиянием, поэтому удаление из листа не требует возврата вверх.
+    bool erase(const T &key)
+    {
+        const size_t t = ORDER / 2; // минимальная степень: у некорневого узла >= t - 1 ключей
+        T target = key;
+        BNode *node = root;
+        bool removed = false;
+
+        while (true)
+        {
+            size_t n = node->keys.get_size();
+            size_t i = 0;
+            while (i < n && node->keys[i] < target)
+                i++;
+
+            if (i < n && node->keys[i] == target)
+            {
+                if (node->is_leaf)
+                {
+                    node->keys.erase(i);
+                    removed = true;
+                    break;
+                }
+
+                BNode *left = node->children[i];
+                BNode *right = node->children[i + 1];
+                if (left->keys.get_size() >= t)
+                {
+                    // заменяем предшественником и удаляем его из левого поддерева
+                    BNode *p = left;
+                    while (!p->is_leaf)
+                        p = p->children[p->children.get_size() - 1];
+                    target = p->keys[p->keys.get_size() - 1];
+                    node->keys[i] = target;
+                    node = left;
+                }
+                else if (right->keys.get_size() >= t)
+                {
+                    // заменяем последователем и удаляем его из правого поддерева
+                    BNode *p = right;
+                    while (!p->is_leaf)
+                        p = p->children[0];
+                    target = p->keys[0];
+                    node->keys[i] = target;
+                    node = right;
+                }
+                else
+                {
+                    merge_children(node, i);
+                    node = left;
+                }
+                continue;
+            }
+
+            if (node->is_leaf)
+                break; // ключа нет
+
+            BNode *child = node->children[i];
+            if (child->keys.get_size() < t)
+            {
+                if (i > 0 && node->children[i - 1]->keys.get_size() >= t)
+                    borrow_from_left(node, i);
+                else if (i < n && node->children[i + 1]->keys.get_size() >= t)
+                    borrow_from_right(node, i);
+                else if (i < n)
+                    merge_children(node, i);
+                else
+                {
+                    merge_children(node, i - 1);
+                    child = node->children[i - 1];
+                }
+            }
+            node = child;
+        }
+
+        // корень опустел после слияния — дерево становится ниже
+        if (root->keys.get_size() == 0 && !root->is_leaf)
+        {
+            BNode *old_root = root;
+            root = root->children[0];
+            pool.destroy(old_root);
+        }
+
+        if (removed)
+            size--;
+        return removed;
+    }
+
     bool contains(const T &key) const
     {
         size_t idx = 0;
@@ -159,20 +496,54 @@ public:
         return n ? &n->keys[idx] : nullptr;
     }
 
-    bool search_slow(const T &key) const
+    const_iterator begin() const
     {
-        volatile int x = 0;
-        for (int i = 0; i < 50000; i++)
-            x += i;
-        return contains(key);
+        const_iterator it;
+        it.push_left(root);
+        it.settle();
+        return it;
+    }
+
+    const_iterator end() const { return const_iterator(); }
+
+    // первый ключ >= key
+    const_iterator lower_bound(const T &key) const
+    {
+        const_iterator it;
+        const BNode *node = root;
+        while (true)
+        {
+            size_t i = 0;
+            while (i < node->keys.get_size() && node->keys[i] < key)
+                i++;
+            it.push(node, i);
+            if (node->is_leaf || (i < node->keys.get_size() && node->keys[i] == key))
+                break;
+            node = node->children[i];
+        }
+        it.settle();
+        return it;
+    }
+
+    // все ключи из [lo, hi] по возрастанию
+    Range range(const T &lo, const T &hi) const
+    {
+        return Range(this, lo, hi);
     }
 
     void clear()
     {
-        delete root;
-        root = new BNode(true);
+        destroy_all();
+        pool.release_all();
+        root = pool.create(true);
         size = 0;
     }
 
     size_t get_size() const { return size; }
+    size_t get_node_count() const { return pool.get_live(); }
+    static constexpr size_t node_bytes() { return sizeof(BNode); }
+
+    // Память живых узлов; reserved_bytes() — весь пул вместе со свободными слотами
+    size_t memory_bytes() const { return pool.get_live() * sizeof(BNode); }
+    size_t reserved_bytes() const { return pool.reserved_bytes(); }
 };
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include "Sequence.h"
+
+/**
+ * @brief Concurrent B+tree with optimistic lock coupling (OLC).
+ *
+ * Every node carries a version latch (lock bit + version counter).
+ * Readers never write shared memory: they record a node's version, read it
+ * and re-validate the version before trusting what they read, restarting
+ * from the root on conflict. Writers descend the same way and upgrade to
+ * exclusive latches only on the node they modify (and its parent when a
+ * split is needed); full nodes are split eagerly on the way down, so a
+ * split never propagates more than one level.
+ *
+ * Nodes are only ever added (no erase), so optimistic readers can never
+ * touch freed memory; nodes are released in the destructor.
+ *
+ * Keys and values must be trivially copyable: an optimistic reader may copy
+ * a slot while a writer is assigning it and only discards the copy after
+ * validation, which is safe for plain bytes but not for owning types.
+ */
+template <typename K, typename V, size_t NODE_BYTES = 256>
+class ConcurrentBTree
+{
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "ConcurrentBTree keys and values must be trivially copyable");
+
+private:
+    // Version latch: bit 1 = locked, higher bits = version
+    class VersionLatch
+    {
+    private:
+        std::atomic<uint64_t> word;
+
+        static bool is_locked(uint64_t v) { return (v & 0b10) != 0; }
+
+    public:
+        VersionLatch() : word(0b100) {}
+
+        uint64_t read_lock_or_restart(bool &restart) const
+        {
+            uint64_t v = word.load(std::memory_order_acquire);
+            if (is_locked(v))
+            {
+                std::this_thread::yield();
+                restart = true;
+            }
+            return v;
+        }
+
+        void check_or_restart(uint64_t version, bool &restart) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version != word.load(std::memory_order_relaxed))
+                restart = true;
+        }
+
+        void upgrade_to_write_lock_or_restart(uint64_t &version, bool &restart)
+        {
+            if (word.compare_exchange_strong(version, version + 0b10, std::memory_order_acquire))
+                version += 0b10;
+            else
+            {
+                std::this_thread::yield();
+                restart = true;
+            }
+        }
+
+        void write_unlock()
+        {
+            word.fetch_add(0b10, std::memory_order_release);
+        }
+    };
+
+    enum class NodeType : uint8_t
+    {
+        Inner,
+        Leaf
+    };
+
+    struct NodeBase
+    {
+        VersionLatch latch;
+        NodeType type;
+        uint16_t count;
+
+        explicit NodeBase(NodeType t) : type(t), count(0) {}
+    };
+
+    static constexpr size_t inner_fit = (NODE_BYTES - sizeof(NodeBase) - sizeof(void *)) / (sizeof(K) + sizeof(void *));
+    static constexpr size_t leaf_fit = (NODE_BYTES - sizeof(NodeBase)) / (sizeof(K) + sizeof(V));
+
+public:
+    static constexpr size_t INNER_KEYS = inner_fit < 3 ? 3 : inner_fit;
+    static constexpr size_t LEAF_KEYS = leaf_fit < 4 ? 4 : leaf_fit;
+
+private:
+    // Inner: keys[i] is the largest key of children[i]; children = count + 1
+    struct Inner : NodeBase
+    {
+        K keys[INNER_KEYS];
+        NodeBase *children[INNER_KEYS + 1];
+
+        Inner() : NodeBase(NodeType::Inner), keys(), children() {}
+
+        bool is_full() const { return this->count == INNER_KEYS; }
+
+        size_t lower_bound(const K &key) const
+        {
+            size_t lo = 0, hi = this->count;
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) / 2;
+                if (keys[mid] < key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        Inner *split(K &separator)
+        {
+            Inner *right = new Inner();
+            size_t mid = this->count / 2;
+            right->count = static_cast<uint16_t>(this->count - mid - 1);
+            for (size_t i = 0; i < right->count; ++i)
+                right->keys[i] = keys[mid + 1 + i];
+            for (size_t i = 0; i <= right->count; ++i)
+                right->children[i] = children[mid + 1 + i];
+            separator = keys[mid];
+            this->count = static_cast<uint16_t>(mid);
+            return right;
+        }
+
+        void insert(const K &key, NodeBase *child)
+        {
+            size_t pos = lower_bound(key);
+            for (size_t i = this->count; i > pos; --i)
+            {
+                keys[i] = keys[i - 1];
+                children[i + 1] = children[i];
+            }
+            keys[pos] = key;
+            children[pos + 1] = child;
+            this->count++;
+        }
+    };
+
+    struct Leaf : NodeBase
+    {
+        K keys[LEAF_KEYS];
+        V values[LEAF_KEYS];
+
+        Leaf() : NodeBase(NodeType::Leaf), keys(), values() {}
+
+        bool is_full() const { return this->count == LEAF_KEYS; }
+
+        size_t lower_bound(const K &key) const
+        {
+            size_t lo = 0, hi = this->count;
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) / 2;
+                if (keys[mid] < key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        // returns false if the key was already present (value overwritten)
+        bool insert(const K &key, const V &value)
+        {
+            size_t pos = lower_bound(key);
+            if (pos < this->count && keys[pos] == key)
+            {
+                values[pos] = value;
+                return false;
+            }
+            for (size_t i = this->count; i > pos; --i)
+            {
+                keys[i] = keys[i - 1];
+                values[i] = values[i - 1];
+            }
+            keys[pos] = key;
+            values[pos] = value;
+            this->count++;
+            return true;
+        }
+
+        Leaf *split(K &separator)
+        {
+            Leaf *right = new Leaf();
+            size_t keep = this->count / 2;
+            right->count = static_cast<uint16_t>(this->count - keep);
+            for (size_t i = 0; i < right->count; ++i)
+            {
+                right->keys[i] = keys[keep + i];
+                right->values[i] = values[keep + i];
+            }
+            this->count = static_cast<uint16_t>(keep);
+            separator = keys[keep - 1];
+            return right;
+        }
+    };
+
+    std::atomic<NodeBase *> root;
+    std::atomic<size_t> size;
+    mutable std::atomic<size_t> restarts;
+
+    void make_root(const K &separator, NodeBase *left, NodeBase *right)
+    {
+        Inner *new_root = new Inner();
+        new_root->count = 1;
+        new_root->keys[0] = separator;
+        new_root->children[0] = left;
+        new_root->children[1] = right;
+        root.store(new_root, std::memory_order_release);
+    }
+
+    void note_restart() const
+    {
+        restarts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Lock parent (if any) and node for a split; false means restart
+    bool lock_for_split(Inner *parent, uint64_t &parent_version, NodeBase *node, uint64_t &node_version)
+    {
+        bool restart = false;
+        if (parent)
+        {
+            parent->latch.upgrade_to_write_lock_or_restart(parent_version, restart);
+            if (restart)
+                return false;
+        }
+        node->latch.upgrade_to_write_lock_or_restart(node_version, restart);
+        if (restart)
+        {
+            if (parent)
+                parent->latch.write_unlock();
+            return false;
+        }
+        if (!parent && node != root.load(std::memory_order_acquire))
+        {
+            // root was split concurrently: node now has a parent we did not lock
+            node->latch.write_unlock();
+            return false;
+        }
+        return true;
+    }
+
+public:
+    ConcurrentBTree() : root(new Leaf()), size(0), restarts(0) {}
+
+    ~ConcurrentBTree()
+    {
+        Sequence<NodeBase *> stack;
+        stack.push_back(root.load());
+        while (!stack.is_empty())
+        {
+            NodeBase *node = stack[stack.get_size() - 1];
+            stack.pop_back();
+            if (node->type == NodeType::Inner)
+            {
+                Inner *inner = static_cast<Inner *>(node);
+                for (size_t i = 0; i <= inner->count; ++i)
+                    stack.push_back(inner->children[i]);
+                delete inner;
+            }
+            else
+                delete static_cast<Leaf *>(node);
+        }
+    }
+
+    ConcurrentBTree(const ConcurrentBTree &) = delete;
+    ConcurrentBTree &operator=(const ConcurrentBTree &) = delete;
+
+    // Lock-free lookup; copies the value into `out`
+    bool find(const K &key, V &out) const
+    {
+        while (true)
+        {
+            bool restart = false;
+            NodeBase *node = root.load(std::memory_order_acquire);
+            uint64_t node_version = node->latch.read_lock_or_restart(restart);
+            if (restart || node != root.load(std::memory_order_acquire))
+            {
+                note_restart();
+                continue;
+            }
+
+            Inner *parent = nullptr;
+            uint64_t parent_version = 0;
+
+            while (node->type == NodeType::Inner)
+            {
+                Inner *inner = static_cast<Inner *>(node);
+                if (parent)
+                {
+                    parent->latch.check_or_restart(parent_version, restart);
+                    if (restart)
+                        break;
+                }
+                parent = inner;
+                parent_version = node_version;
+
+                node = inner->children[inner->lower_bound(key)];
+                inner->latch.check_or_restart(node_version, restart);
+                if (restart)
+                    break;
+                node_version = node->latch.read_lock_or_restart(restart);
+                if (restart)
+                    break;
+            }
+            if (restart)
+            {
+                note_restart();
+                continue;
+            }
+
+            Leaf *leaf = static_cast<Leaf *>(node);
+            size_t pos = leaf->lower_bound(key);
+            bool found = pos < leaf->count && leaf->keys[pos] == key;
+            V value = found ? leaf->values[pos] : V();
+
+            if (parent)
+                parent->latch.check_or_restart(parent_version, restart);
+            if (!restart)
+                leaf->latch.check_or_restart(node_version, restart);
+            if (restart)
+            {
+                note_restart();
+                continue;
+            }
+            if (found)
+                out = value;
+            return found;
+        }
+    }
+
+    bool contains(const K &key) const
+    {
+        V dummy;
+        return find(key, dummy);
+    }
+
+    // Insert or overwrite
+    void insert(const K &key, const V &value)
+    {
+        while (true)
+        {
+            bool restart = false;
+            NodeBase *node = root.load(std::memory_order_acquire);
+            uint64_t node_version = node->latch.read_lock_or_restart(restart);
+            if (restart || node != root.load(std::memory_order_acquire))
+            {
+                note_restart();
+                continue;
+            }
+
+            Inner *parent = nullptr;
+            uint64_t parent_version = 0;
+            bool retry = false;
+
+            while (node->type == NodeType::Inner)
+            {
+                Inner *inner = static_cast<Inner *>(node);
+
+                // eager split keeps room in every parent we pass through
+                if (inner->is_full())
+                {
+                    if (lock_for_split(parent, parent_version, node, node_version))
+                    {
+                        K separator;
+                        Inner *right = inner->split(separator);
+                        if (parent)
+                            parent->insert(separator, right);
+                        else
+                            make_root(separator, inner, right);
+                        node->latch.write_unlock();
+                        if (parent)
+                            parent->latch.write_unlock();
+                    }
+                    retry = true;
+                    break;
+                }
+
+                if (parent)
+                {
+                    parent->latch.check_or_restart(parent_version, restart);
+                    if (restart)
+                        break;
+                }
+                parent = inner;
+                parent_version = node_version;
+
+                node = inner->children[inner->lower_bound(key)];
+                inner->latch.check_or_restart(node_version, restart);
+                if (restart)
+                    break;
+                node_version = node->latch.read_lock_or_restart(restart);
+                if (restart)
+                    break;
+            }
+            if (restart || retry)
+            {
+                note_restart();
+                continue;
+            }
+
+            Leaf *leaf = static_cast<Leaf *>(node);
+            if (leaf->is_full())
+            {
+                if (lock_for_split(parent, parent_version, node, node_version))
+                {
+                    K separator;
+                    Leaf *right = leaf->split(separator);
+                    if (parent)
+                        parent->insert(separator, right);
+                    else
+                        make_root(separator, leaf, right);
+                    node->latch.write_unlock();
+                    if (parent)
+                        parent->latch.write_unlock();
+                }
+                note_restart();
+                continue;
+            }
+
+            // only the leaf is latched exclusively
+            node->latch.upgrade_to_write_lock_or_restart(node_version, restart);
+            if (restart)
+            {
+                note_restart();
+                continue;
+            }
+            if (parent)
+            {
+                parent->latch.check_or_restart(parent_version, restart);
+                if (restart)
+                {
+                    node->latch.write_unlock();
+                    note_restart();
+                    continue;
+                }
+            }
+            if (leaf->insert(key, value))
+                size.fetch_add(1, std::memory_order_relaxed);
+            node->latch.write_unlock();
+            return;
+        }
+    }
+
+    size_t get_size() const { return size.load(std::memory_order_relaxed); }
+    size_t get_restarts() const { return restarts.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include "Sequence.h"
+#include "Dictionary.h"
+#include "EpochManager.h"
+
+/**
+ * @brief Hash table for many threads: lock-free reads, lock-striped writes.
+ *
+ * Buckets are singly linked chains of immutable nodes. Readers take no
+ * lock: inside an EpochGuard they follow the atomic links and copy the
+ * value out. Writers lock one of STRIPES mutexes, picked by the low bits
+ * of the hash; since the bucket count is a power of two and at least
+ * STRIPES, all keys of a bucket share a stripe, and writers to different
+ * stripes never wait for each other. An update replaces the node instead
+ * of writing into it, so a reader never sees a half-written value.
+ * Unlinked nodes go to the EpochManager and are freed once no reader can
+ * still hold them.
+ *
+ * Growing takes all stripes, builds a table of twice the size from copies
+ * of the nodes and publishes it with one atomic store. Readers keep running
+ * during a resize (on the old table until the new one appears); the writer
+ * that grew the table then waits for them to leave it and frees it.
+ */
+template <typename K, typename V>
+class ConcurrentDictionary
+{
+private:
+    using Entry = Pair<K, V>;
+    static constexpr size_t STRIPES = 64;
+    static constexpr size_t INITIAL_CAPACITY = 64;
+    static constexpr double LOAD_FACTOR_EXPAND = 0.75;
+    static_assert((STRIPES & (STRIPES - 1)) == 0 && INITIAL_CAPACITY >= STRIPES, "stripe count must divide the bucket count");
+
+    struct Node
+    {
+        const K key;
+        const V value;
+        std::atomic<Node *> next;
+
+        Node(const K &k, const V &v, Node *n) : key(k), value(v), next(n) {}
+    };
+
+    struct Table
+    {
+        size_t capacity;
+        std::atomic<Node *> *heads;
+
+        explicit Table(size_t cap) : capacity(cap), heads(new std::atomic<Node *>[cap])
+        {
+            for (size_t i = 0; i < cap; ++i)
+                heads[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~Table()
+        {
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                Node *n = heads[i].load(std::memory_order_relaxed);
+                while (n)
+                {
+                    Node *next = n->next.load(std::memory_order_relaxed);
+                    delete n;
+                    n = next;
+                }
+            }
+            delete[] heads;
+        }
+    };
+
+    // one mutex per cache line so neighbouring stripes don't share a line
+    struct alignas(64) Stripe
+    {
+        std::mutex mtx;
+    };
+
+    std::atomic<Table *> table;
+    std::atomic<size_t> size;
+    Stripe stripes[STRIPES];
+
+    // std::hash<int> is the identity: spread the bits before masking
+    static size_t hash_code(const K &key)
+    {
+        uint64_t h = static_cast<uint64_t>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    std::mutex &stripe_for(size_t hash) { return stripes[hash & (STRIPES - 1)].mtx; }
+
+    bool overloaded(size_t capacity) const
+    {
+        return static_cast<double>(size.load(std::memory_order_relaxed)) >= static_cast<double>(capacity) * LOAD_FACTOR_EXPAND;
+    }
+
+    void lock_all()
+    {
+        for (Stripe &s : stripes)
+            s.mtx.lock();
+    }
+
+    void unlock_all()
+    {
+        for (Stripe &s : stripes)
+            s.mtx.unlock();
+    }
+
+    void grow()
+    {
+        lock_all();
+        Table *old = table.load(std::memory_order_relaxed);
+        // another writer may have grown it while we waited; check against the
+        // current table, not the one we saw, or a crossing seen on a stale
+        // capacity would leave the table overfull
+        if (!overloaded(old->capacity))
+        {
+            unlock_all();
+            return;
+        }
+
+        Table *fresh = new Table(old->capacity * 2);
+        size_t mask = fresh->capacity - 1;
+        for (size_t i = 0; i < old->capacity; ++i)
+        {
+            for (Node *n = old->heads[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed))
+            {
+                std::atomic<Node *> &head = fresh->heads[hash_code(n->key) & mask];
+                head.store(new Node(n->key, n->value, head.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+            }
+        }
+        table.store(fresh, std::memory_order_release);
+        unlock_all();
+        // free the old copy now rather than whenever enough small retires have piled up
+        EpochManager::instance().retire(old);
+        EpochManager::instance().synchronize();
+    }
+
+public:
+    ConcurrentDictionary() : table(new Table(INITIAL_CAPACITY)), size(0) {}
+
+    // Not safe while other threads still use the dictionary
+    ~ConcurrentDictionary() { delete table.load(); }
+
+    ConcurrentDictionary(const ConcurrentDictionary &) = delete;
+    ConcurrentDictionary &operator=(const ConcurrentDictionary &) = delete;
+
+    // Insert or overwrite
+    void insert(const K &key, const V &value)
+    {
+        size_t hash = hash_code(key);
+        size_t capacity;
+        {
+            std::lock_guard<std::mutex> lock(stripe_for(hash));
+            Table *t = table.load(std::memory_order_relaxed); // stable while a stripe is held
+            capacity = t->capacity;
+            std::atomic<Node *> &head = t->heads[hash & (capacity - 1)];
+
+            for (std::atomic<Node *> *link = &head; Node *n = link->load(std::memory_order_relaxed); link = &n->next)
+            {
+                if (n->key == key)
+                {
+                    link->store(new Node(key, value, n->next.load(std::memory_order_relaxed)), std::memory_order_release);
+                    EpochManager::instance().retire(n);
+                    return;
+                }
+            }
+            head.store(new Node(key, value, head.load(std::memory_order_relaxed)), std::memory_order_release);
+        }
+
+        size.fetch_add(1, std::memory_order_relaxed);
+        if (overloaded(capacity))
+            grow();
+    }
+
+    // Copy the value for `key` into `out`; lock-free
+    bool find(const K &key, V &out) const
+    {
+        size_t hash = hash_code(key);
+        EpochGuard guard;
+        const Table *t = table.load(std::memory_order_acquire);
+        for (Node *n = t->heads[hash & (t->capacity - 1)].load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire))
+        {
+            if (n->key == key)
+            {
+                out = n->value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(const K &key) const
+    {
+        size_t hash = hash_code(key);
+        EpochGuard guard;
+        const Table *t = table.load(std::memory_order_acquire);
+        for (Node *n = t->heads[hash & (t->capacity - 1)].load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire))
+        {
+            if (n->key == key)
+                return true;
+        }
+        return false;
+    }
+
+    bool erase(const K &key)
+    {
+        size_t hash = hash_code(key);
+        std::lock_guard<std::mutex> lock(stripe_for(hash));
+        Table *t = table.load(std::memory_order_relaxed);
+        std::atomic<Node *> *link = &t->heads[hash & (t->capacity - 1)];
+        for (; Node *n = link->load(std::memory_order_relaxed); link = &n->next)
+        {
+            if (n->key == key)
+            {
+                link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+                EpochManager::instance().retire(n);
+                size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        lock_all();
+        Table *old = table.load(std::memory_order_relaxed);
+        table.store(new Table(INITIAL_CAPACITY), std::memory_order_release);
+        size.store(0, std::memory_order_relaxed);
+        unlock_all();
+        EpochManager::instance().retire(old);
+        EpochManager::instance().synchronize();
+    }
+
+    size_t get_size() const { return size.load(std::memory_order_relaxed); }
+    size_t get_capacity() const { return table.load(std::memory_order_acquire)->capacity; }
+
+    // Copy of all pairs; consistent per bucket, not across the whole table
+    Sequence<Entry> get_all_entries() const
+    {
+        Sequence<Entry> result;
+        EpochGuard guard;
+        const Table *t = table.load(std::memory_order_acquire);
+        for (size_t i = 0; i < t->capacity; ++i)
+            for (Node *n = t->heads[i].load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire))
+                result.push_back(Entry(n->key, n->value));
+        return result;
+    }
+};
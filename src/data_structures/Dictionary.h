@@ -1,7 +1,10 @@
 #pragma once
 
 #include "Sequence.h"
+#include "SmallSequence.h"
 #include <functional>
+#include <stdexcept>
+#include <type_traits>
 
 template <typename K, typename V>
 struct Pair
@@ -18,7 +21,9 @@ class Dictionary
 {
 private:
     using Entry = Pair<K, V>;
-    using Bucket = Sequence<Entry>;
+    // at load factor <= 0.75 almost every bucket holds 0-2 entries: keep them inline
+    static constexpr size_t BUCKET_INLINE = sizeof(Entry) <= 32 ? 2 : 1;
+    using Bucket = SmallSequence<Entry, BUCKET_INLINE>;
 
     Bucket *buckets;
     size_t capacity;
@@ -51,15 +56,85 @@ private:
         {
             for (size_t j = 0; j < old_buckets[i].get_size(); ++j)
             {
-                const auto &entry = old_buckets[i][j];
+                auto &entry = old_buckets[i][j];
                 size_t new_idx = std::hash<K>()(entry.key) % capacity;
-                buckets[new_idx].push_back(entry);
+                buckets[new_idx].push_back(std::move(entry));
             }
         }
         delete[] old_buckets;
     }
 
+    // Insert or overwrite without the load-factor check; true if the key was new
+    bool put(const K &key, const V &value)
+    {
+        Bucket &bucket = buckets[get_bucket_index(key)];
+        for (size_t i = 0; i < bucket.get_size(); ++i)
+        {
+            if (bucket[i].key == key)
+            {
+                bucket[i].value = value;
+                return false;
+            }
+        }
+        bucket.push_back(Entry(key, value));
+        size++;
+        return true;
+    }
+
+    void grow_if_needed()
+    {
+        if (static_cast<double>(size) >= static_cast<double>(capacity) * LOAD_FACTOR_EXPAND)
+            rehash(capacity * 2);
+    }
+
 public:
+    // Walks the buckets in order; no copies, no allocation. Keys must not be changed through it.
+    template <bool CONST>
+    class basic_iterator
+    {
+    private:
+        using BucketPtr = typename std::conditional<CONST, const Bucket *, Bucket *>::type;
+        BucketPtr buckets;
+        size_t capacity;
+        size_t bucket;
+        size_t slot;
+
+        void skip_empty()
+        {
+            while (bucket < capacity && slot >= buckets[bucket].get_size())
+            {
+                bucket++;
+                slot = 0;
+            }
+        }
+
+    public:
+        using value_type = Entry;
+        using reference = typename std::conditional<CONST, const Entry &, Entry &>::type;
+        using pointer = typename std::conditional<CONST, const Entry *, Entry *>::type;
+
+        basic_iterator(BucketPtr b, size_t cap, size_t start) : buckets(b), capacity(cap), bucket(start), slot(0)
+        {
+            skip_empty();
+        }
+
+        reference operator*() const { return buckets[bucket].begin()[slot]; }
+        pointer operator->() const { return buckets[bucket].begin() + slot; }
+
+        basic_iterator &operator++()
+        {
+            slot++;
+            skip_empty();
+            return *this;
+        }
+
+        bool operator==(const basic_iterator &other) const { return bucket == other.bucket && slot == other.slot; }
+        bool operator!=(const basic_iterator &other) const { return !(*this == other); }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
     Dictionary() : buckets(nullptr), capacity(INITIAL_CAPACITY), size(0)
     {
         buckets = new Bucket[capacity];
@@ -73,24 +148,36 @@ public:
 
     void insert(const K &key, const V &value)
     {
-        size_t idx = get_bucket_index(key);
+        if (put(key, value))
+            grow_if_needed();
+    }
 
-        for (size_t i = 0; i < buckets[idx].get_size(); ++i)
-        {
-            if (buckets[idx][i].key == key)
-            {
-                buckets[idx][i].value = value;
-                return;
-            }
-        }
+    // Grow once so that `n` entries fit without further rehashing
+    void reserve(size_t n)
+    {
+        size_t target = capacity;
+        while (static_cast<double>(n) >= static_cast<double>(target) * LOAD_FACTOR_EXPAND)
+            target *= 2;
+        if (target != capacity)
+            rehash(target);
+    }
 
-        buckets[idx].push_back(Entry(key, value));
-        size++;
+    // Insert (or overwrite) all pairs, rehashing at most once
+    void insert_bulk(const Sequence<Entry> &entries)
+    {
+        reserve(size + entries.get_size());
+        for (const Entry &e : entries)
+            put(e.key, e.value);
+    }
 
-        if (static_cast<double>(size) >= static_cast<double>(capacity) * LOAD_FACTOR_EXPAND)
-        {
-            rehash(capacity * 2);
-        }
+    // Insert keys[i] -> values[i] for every i, rehashing at most once
+    void insert_bulk(const Sequence<K> &keys, const Sequence<V> &values)
+    {
+        if (keys.get_size() != values.get_size())
+            throw std::invalid_argument("insert_bulk: keys and values differ in length");
+        reserve(size + keys.get_size());
+        for (size_t i = 0; i < keys.get_size(); ++i)
+            put(keys.begin()[i], values.begin()[i]);
     }
 
     V *find(const K &key)
@@ -139,6 +226,29 @@ public:
         return false;
     }
 
+    // Remove every entry for which pred(entry) is true; returns how many were removed
+    template <typename Pred>
+    size_t erase_if(Pred pred)
+    {
+        size_t removed = 0;
+        for (size_t b = 0; b < capacity; ++b)
+        {
+            Bucket &bucket = buckets[b];
+            for (size_t i = 0; i < bucket.get_size();)
+            {
+                if (pred(static_cast<const Entry &>(bucket[i])))
+                {
+                    bucket.erase(i);
+                    removed++;
+                }
+                else
+                    ++i;
+            }
+        }
+        size -= removed;
+        return removed;
+    }
+
     void clear()
     {
         for (size_t i = 0; i < capacity; ++i)
@@ -151,17 +261,18 @@ public:
     size_t get_size() const { return size; }
     size_t get_capacity() const { return capacity; }
 
-    // Return a copy of all stored pairs (for inspection / tests)
+    iterator begin() { return iterator(buckets, capacity, 0); }
+    iterator end() { return iterator(buckets, capacity, capacity); }
+    const_iterator begin() const { return const_iterator(buckets, capacity, 0); }
+    const_iterator end() const { return const_iterator(buckets, capacity, capacity); }
+
+    // Return a copy of all stored pairs (for inspection / tests); prefer iterating when a copy isn't needed
     Sequence<Entry> get_all_entries() const
     {
         Sequence<Entry> result;
-        for (size_t i = 0; i < capacity; ++i)
-        {
-            for (size_t j = 0; j < buckets[i].get_size(); ++j)
-            {
-                result.push_back(buckets[i][j]);
-            }
-        }
+        result.reserve(size);
+        for (const Entry &e : *this)
+            result.push_back(e);
         return result;
     }
 };
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Epoch-based reclamation for lock-free readers.
+ *
+ * A reader wraps its traversal in an EpochGuard, which publishes the global
+ * epoch it started in. A writer that unlinks an object hands it to retire()
+ * instead of deleting it; the object is tagged with the current epoch and
+ * freed once the global epoch has advanced twice past that tag. The epoch
+ * only advances when every active reader has caught up with it, so by then
+ * no reader can still hold a pointer obtained before the unlink.
+ *
+ * One process-wide instance (instance()) serves all containers; each thread
+ * takes a slot on first use and gives it back when it exits.
+ */
+class EpochManager
+{
+private:
+    static constexpr uint64_t IDLE = ~uint64_t(0);
+    static constexpr size_t RECLAIM_EVERY = 64;
+
+    struct Slot
+    {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> in_use{false};
+        Slot *next = nullptr;
+        size_t nesting = 0; // touched only by the owning thread
+    };
+
+    struct Retired
+    {
+        void *object;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    std::atomic<uint64_t> global_epoch;
+    std::atomic<Slot *> slots;
+    std::mutex retired_mtx;
+    std::vector<Retired> retired;
+    size_t retires_since_reclaim;
+
+    // Slot of the calling thread, released when the thread exits
+    Slot &own_slot()
+    {
+        struct Handle
+        {
+            Slot *slot = nullptr;
+            ~Handle()
+            {
+                if (slot)
+                {
+                    slot->epoch.store(IDLE);
+                    slot->in_use.store(false);
+                }
+            }
+        };
+        static thread_local Handle handle;
+        if (!handle.slot)
+            handle.slot = acquire_slot();
+        return *handle.slot;
+    }
+
+    Slot *acquire_slot()
+    {
+        for (Slot *s = slots.load(); s; s = s->next)
+        {
+            bool expected = false;
+            if (!s->in_use.load() && s->in_use.compare_exchange_strong(expected, true))
+                return s;
+        }
+        // slots are never freed, so the list can be walked without locking
+        Slot *s = new Slot();
+        s->in_use.store(true);
+        Slot *head = slots.load();
+        do
+            s->next = head;
+        while (!slots.compare_exchange_weak(head, s));
+        return s;
+    }
+
+    // Advance the epoch if every active reader is in the current one
+    bool try_advance()
+    {
+        uint64_t e = global_epoch.load();
+        for (Slot *s = slots.load(); s; s = s->next)
+        {
+            uint64_t local = s->epoch.load();
+            if (local != IDLE && local != e)
+                return false;
+        }
+        return global_epoch.compare_exchange_strong(e, e + 1);
+    }
+
+    // Free what is at least two epochs old; call with retired_mtx held
+    void free_expired(std::vector<Retired> &out)
+    {
+        uint64_t e = global_epoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); ++i)
+        {
+            if (retired[i].epoch + 2 <= e)
+                out.push_back(retired[i]);
+            else
+                retired[kept++] = retired[i];
+        }
+        retired.resize(kept);
+    }
+
+    EpochManager() : global_epoch(0), slots(nullptr), retires_since_reclaim(0) {}
+
+public:
+    ~EpochManager()
+    {
+        for (const Retired &r : retired)
+            r.deleter(r.object);
+        Slot *s = slots.load();
+        while (s)
+        {
+            Slot *next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    EpochManager(const EpochManager &) = delete;
+    EpochManager &operator=(const EpochManager &) = delete;
+
+    static EpochManager &instance()
+    {
+        static EpochManager manager;
+        return manager;
+    }
+
+    void enter()
+    {
+        Slot &s = own_slot();
+        if (s.nesting++ > 0)
+            return;
+        // publish, then re-check: an epoch read just before an advance would be stale
+        uint64_t e = global_epoch.load();
+        while (true)
+        {
+            s.epoch.store(e);
+            uint64_t now = global_epoch.load();
+            if (now == e)
+                break;
+            e = now;
+        }
+    }
+
+    void exit()
+    {
+        Slot &s = own_slot();
+        // release is enough: only the reads inside the guard must stay before it
+        if (--s.nesting == 0)
+            s.epoch.store(IDLE, std::memory_order_release);
+    }
+
+    // Delete `object` with `deleter` once no reader can reach it any more
+    void retire(void *object, void (*deleter)(void *))
+    {
+        std::vector<Retired> expired;
+        {
+            std::lock_guard<std::mutex> lock(retired_mtx);
+            retired.push_back({object, deleter, global_epoch.load()});
+            if (++retires_since_reclaim < RECLAIM_EVERY)
+                return;
+            retires_since_reclaim = 0;
+            try_advance();
+            free_expired(expired);
+        }
+        for (const Retired &r : expired)
+            r.deleter(r.object);
+    }
+
+    template <typename T>
+    void retire(T *object)
+    {
+        retire(object, [](void *p)
+               { delete static_cast<T *>(p); });
+    }
+
+    // Try to advance the epoch and free what has expired; returns how many objects were freed
+    size_t try_reclaim()
+    {
+        std::vector<Retired> expired;
+        {
+            std::lock_guard<std::mutex> lock(retired_mtx);
+            try_advance();
+            free_expired(expired);
+        }
+        for (const Retired &r : expired)
+            r.deleter(r.object);
+        return expired.size();
+    }
+
+    /**
+     * Wait until every reader that is active now has left its guard, then
+     * free what has expired (including everything retired before the call).
+     * For writers that retire something large, such as a whole table.
+     */
+    void synchronize()
+    {
+        if (own_slot().nesting > 0)
+            throw std::logic_error("EpochManager::synchronize called inside an EpochGuard");
+        uint64_t target = global_epoch.load() + 2;
+        while (global_epoch.load() < target)
+        {
+            if (!try_advance())
+                std::this_thread::yield();
+        }
+        try_reclaim();
+    }
+
+    size_t get_pending()
+    {
+        std::lock_guard<std::mutex> lock(retired_mtx);
+        return retired.size();
+    }
+
+    uint64_t get_epoch() const { return global_epoch.load(); }
+};
+
+// RAII read-side critical section: pointers loaded inside stay valid until it ends
+class EpochGuard
+{
+public:
+    EpochGuard() { EpochManager::instance().enter(); }
+    ~EpochGuard() { EpochManager::instance().exit(); }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Sequence.h"
+
+/**
+ * @brief Immutable sorted index in Eytzinger (BFS) order.
+ *
+ * The sorted keys are laid out as an implicit binary heap: node k has
+ * children 2k and 2k+1, so the first levels of every search share a few
+ * cache lines and there are no child pointers to chase. Search is
+ * branchless (the comparison result becomes part of the next index) and
+ * prefetches the line holding the descendants several levels ahead.
+ *
+ * Built once from sorted data; there is no insert or erase.
+ */
+template <typename T>
+class EytzingerIndex
+{
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    // elements per cache line: prefetching node k * STRIDE fetches k's descendants that many levels down
+    static constexpr size_t STRIDE = sizeof(T) < CACHE_LINE ? CACHE_LINE / sizeof(T) : 1;
+
+    std::vector<T> storage;
+    size_t offset; // storage[offset] is slot 0, aligned to a cache line when possible
+    size_t n;
+
+    T *base() { return storage.data() + offset; }
+    const T *base() const { return storage.data() + offset; }
+
+    // in-order walk of the implicit tree assigns sorted[i] to slots left to right
+    size_t fill(const Sequence<T> &sorted, size_t i, size_t k)
+    {
+        if (k <= n)
+        {
+            i = fill(sorted, i, 2 * k);
+            base()[k] = sorted[i++];
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // Slot of the first element >= key, 0 if there is none
+    size_t lower_bound_slot(const T &key) const
+    {
+        const T *b = base();
+        size_t k = 1;
+        while (k <= n)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(b + k * STRIDE);
+#endif
+            k = 2 * k + static_cast<size_t>(b[k] < key);
+        }
+        // undo the trailing right turns plus the final left one
+#if defined(__GNUC__) || defined(__clang__)
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+#else
+        while (k & 1)
+            k >>= 1;
+        k >>= 1;
+#endif
+        return k;
+    }
+
+public:
+    EytzingerIndex() : offset(0), n(0) {}
+
+    explicit EytzingerIndex(const Sequence<T> &sorted) : EytzingerIndex() { build(sorted); }
+
+    EytzingerIndex(const EytzingerIndex &) = delete;
+    EytzingerIndex &operator=(const EytzingerIndex &) = delete;
+    EytzingerIndex(EytzingerIndex &&) = default;
+    EytzingerIndex &operator=(EytzingerIndex &&) = default;
+
+    // Rebuild from sorted data (throws invalid_argument otherwise)
+    void build(const Sequence<T> &sorted)
+    {
+        for (size_t i = 1; i < sorted.get_size(); ++i)
+            if (sorted[i] < sorted[i - 1])
+                throw std::invalid_argument("EytzingerIndex requires sorted input");
+
+        n = sorted.get_size();
+        std::vector<T> fresh(n + 1 + CACHE_LINE / sizeof(T) + 1);
+        storage.swap(fresh);
+
+        offset = 0;
+        if (CACHE_LINE % sizeof(T) == 0)
+        {
+            uintptr_t addr = reinterpret_cast<uintptr_t>(storage.data());
+            offset = ((CACHE_LINE - addr % CACHE_LINE) % CACHE_LINE) / sizeof(T);
+        }
+        fill(sorted, 0, 1);
+    }
+
+    const T *search(const T &key) const
+    {
+        size_t k = lower_bound_slot(key);
+        return k != 0 && !(key < base()[k]) ? &base()[k] : nullptr;
+    }
+
+    T *search(const T &key)
+    {
+        size_t k = lower_bound_slot(key);
+        return k != 0 && !(key < base()[k]) ? &base()[k] : nullptr;
+    }
+
+    bool contains(const T &key) const { return search(key) != nullptr; }
+
+    // Smallest element >= key, nullptr if every element is smaller
+    const T *lower_bound(const T &key) const
+    {
+        size_t k = lower_bound_slot(key);
+        return k != 0 ? &base()[k] : nullptr;
+    }
+
+    void clear()
+    {
+        std::vector<T>().swap(storage);
+        offset = 0;
+        n = 0;
+    }
+
+    size_t get_size() const { return n; }
+    bool is_empty() const { return n == 0; }
+    size_t memory_bytes() const { return storage.capacity() * sizeof(T); }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+
+// Fixed-capacity array stored inline (no heap allocation).
+// Mirrors the subset of the Sequence interface used by tree nodes.
+template <typename T, size_t N>
+class InlineArray
+{
+private:
+    T data[N];
+    size_t size;
+
+public:
+    InlineArray() : data(), size(0) {}
+
+    void push_back(const T &value)
+    {
+        if (size >= N)
+            throw std::length_error("InlineArray capacity exceeded");
+        data[size++] = value;
+    }
+
+    void pop_back()
+    {
+        if (size > 0)
+            size--;
+    }
+
+    void insert(size_t index, const T &value)
+    {
+        if (index > size)
+            throw std::out_of_range("Index out of range");
+        if (size >= N)
+            throw std::length_error("InlineArray capacity exceeded");
+
+        for (size_t i = size; i > index; --i)
+            data[i] = data[i - 1];
+
+        data[index] = value;
+        size++;
+    }
+
+    void erase(size_t index)
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+
+        for (size_t i = index; i + 1 < size; ++i)
+            data[i] = data[i + 1];
+
+        size--;
+    }
+
+    void clear() { size = 0; }
+
+    T &operator[](size_t index)
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return data[index];
+    }
+
+    const T &operator[](size_t index) const
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return data[index];
+    }
+
+    size_t get_size() const { return size; }
+    static constexpr size_t get_capacity() { return N; }
+    bool is_empty() const { return size == 0; }
+
+    T *begin() { return data; }
+    T *end() { return data + size; }
+    const T *begin() const { return data; }
+    const T *end() const { return data + size; }
+};
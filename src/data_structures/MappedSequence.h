@@ -0,0 +1,151 @@
+#pragma once
+
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "Sequence.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * @brief Read-only view of a file of fixed-size records, mapped into memory.
+ *
+ * The file is a plain array of T (see write_file), so T must be trivially
+ * copyable. Nothing is copied when opening: pages are read by the OS on
+ * first access and stay in the page cache, which then acts as the cold
+ * tier below an in-process cache. Where mmap is unavailable the file is
+ * read into a heap buffer instead.
+ */
+template <typename T>
+class MappedSequence
+{
+private:
+    const T *data;
+    size_t size;
+    size_t mapped_bytes;
+#ifdef _WIN32
+    std::unique_ptr<T[]> buffer;
+#endif
+
+    void close_mapping()
+    {
+#ifndef _WIN32
+        if (data && mapped_bytes > 0)
+            ::munmap(const_cast<T *>(data), mapped_bytes);
+#else
+        buffer.reset();
+#endif
+        data = nullptr;
+        size = 0;
+        mapped_bytes = 0;
+    }
+
+public:
+    MappedSequence() : data(nullptr), size(0), mapped_bytes(0) {}
+
+    explicit MappedSequence(const std::string &path) : MappedSequence() { open(path); }
+
+    ~MappedSequence() { close_mapping(); }
+
+    MappedSequence(const MappedSequence &) = delete;
+    MappedSequence &operator=(const MappedSequence &) = delete;
+
+    // Write `records` as a file that open() can map
+    static void write_file(const std::string &path, const Sequence<T> &records)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "MappedSequence records must be trivially copyable");
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f)
+            throw std::runtime_error("MappedSequence: cannot create " + path);
+        size_t written = records.get_size() == 0 ? 0 : std::fwrite(records.begin(), sizeof(T), records.get_size(), f);
+        std::fclose(f);
+        if (written != records.get_size())
+            throw std::runtime_error("MappedSequence: write failed for " + path);
+    }
+
+    void open(const std::string &path)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "MappedSequence records must be trivially copyable");
+        close_mapping();
+
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("MappedSequence: cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MappedSequence: cannot stat " + path);
+        }
+        size_t bytes = static_cast<size_t>(st.st_size);
+        if (bytes % sizeof(T) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MappedSequence: " + path + " is not a whole number of records");
+        }
+        if (bytes > 0)
+        {
+            void *p = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("MappedSequence: mmap failed for " + path);
+            }
+            // cache misses arrive in random order: don't read ahead
+            ::madvise(p, bytes, MADV_RANDOM);
+            data = static_cast<const T *>(p);
+        }
+        ::close(fd); // the mapping keeps the file alive
+        mapped_bytes = bytes;
+        size = bytes / sizeof(T);
+#else
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f)
+            throw std::runtime_error("MappedSequence: cannot open " + path);
+        std::fseek(f, 0, SEEK_END);
+        size_t bytes = static_cast<size_t>(std::ftell(f));
+        std::fseek(f, 0, SEEK_SET);
+        if (bytes % sizeof(T) != 0)
+        {
+            std::fclose(f);
+            throw std::runtime_error("MappedSequence: " + path + " is not a whole number of records");
+        }
+        size = bytes / sizeof(T);
+        buffer.reset(new T[size]);
+        if (std::fread(buffer.get(), sizeof(T), size, f) != size)
+        {
+            std::fclose(f);
+            buffer.reset();
+            size = 0;
+            throw std::runtime_error("MappedSequence: read failed for " + path);
+        }
+        std::fclose(f);
+        data = buffer.get();
+#endif
+    }
+
+    void close() { close_mapping(); }
+
+    const T &operator[](size_t index) const
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return data[index];
+    }
+
+    size_t get_size() const { return size; }
+    bool is_empty() const { return size == 0; }
+    bool is_open() const { return data != nullptr; }
+
+    const T *begin() const { return data; }
+    const T *end() const { return data + size; }
+};
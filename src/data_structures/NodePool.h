@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "Sequence.h"
+
+/**
+ * @brief Slab allocator for fixed-size tree nodes.
+ *
+ * Nodes are carved from slabs of NODES_PER_SLAB objects; released nodes
+ * go to an intrusive free list and are reused before a new slab is taken.
+ * The owner must destroy() every live node before the pool goes away;
+ * slabs are returned to the system only by release_all() / the destructor.
+ */
+template <typename Node, size_t NODES_PER_SLAB = 1024>
+class NodePool
+{
+private:
+    union Slot
+    {
+        Slot *next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    Sequence<Slot *> slabs;
+    Slot *free_list;
+    size_t used_in_last; // slots handed out from the newest slab
+    size_t live;
+
+public:
+    NodePool() : free_list(nullptr), used_in_last(NODES_PER_SLAB), live(0) {}
+
+    ~NodePool()
+    {
+        release_all();
+    }
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    template <typename... Args>
+    Node *create(Args &&...args)
+    {
+        Slot *slot;
+        if (free_list)
+        {
+            slot = free_list;
+            free_list = free_list->next;
+        }
+        else
+        {
+            if (used_in_last == NODES_PER_SLAB)
+            {
+                slabs.push_back(new Slot[NODES_PER_SLAB]);
+                used_in_last = 0;
+            }
+            slot = &slabs[slabs.get_size() - 1][used_in_last++];
+        }
+        live++;
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+
+    void destroy(Node *node)
+    {
+        node->~Node();
+        Slot *slot = reinterpret_cast<Slot *>(node);
+        slot->next = free_list;
+        free_list = slot;
+        live--;
+    }
+
+    // Free every slab; all nodes must already be destroyed
+    void release_all()
+    {
+        for (size_t i = 0; i < slabs.get_size(); ++i)
+            delete[] slabs[i];
+        slabs.clear();
+        free_list = nullptr;
+        used_in_last = NODES_PER_SLAB;
+        live = 0;
+    }
+
+    size_t get_live() const { return live; }
+    size_t reserved_bytes() const { return slabs.get_size() * NODES_PER_SLAB * sizeof(Slot); }
+};
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+#include "../cache/BufferPool.h"
+
+/**
+ * @brief Persistent, page-oriented B+tree with int keys and fixed-size values.
+ *
+ * File layout: page 0 is the file header, every other page is one node.
+ * Leaves store keys and values and are chained through `next`; inner nodes
+ * store separator keys and child page ids. All node access goes through a
+ * BufferPool, so only the hot part of the tree has to be in memory and a
+ * reopened file is usable immediately, without rebuilding.
+ *
+ * The file is not crash-consistent: dirty pages and the header reach it
+ * only through flush(). Call flush() explicitly to persist the tree and see
+ * I/O errors; the destructor flushes too but swallows errors. A file left
+ * behind by a process that died before flush() must not be reopened.
+ */
+template <typename V>
+class PagedBTree
+{
+    static_assert(std::is_trivially_copyable<V>::value, "PagedBTree values must be trivially copyable");
+
+private:
+    static constexpr size_t PAGE_SIZE = BufferPool::PAGE_SIZE;
+    static constexpr uint64_t MAGIC = 0x31455254424750ULL; // "PGBTRE1"
+    static constexpr size_t MAX_DEPTH = 32;
+
+    struct FileHeader
+    {
+        uint64_t magic;
+        uint32_t page_size;
+        uint32_t value_size;
+        uint32_t root;
+        uint32_t page_count;
+        uint32_t height;
+        uint32_t reserved;
+        uint64_t size;
+    };
+
+    struct NodeHeader
+    {
+        uint16_t is_leaf;
+        uint16_t count;
+        uint32_t next; // right sibling leaf, 0 = none
+        uint64_t reserved;
+    };
+
+public:
+    static constexpr size_t LEAF_CAPACITY = (PAGE_SIZE - sizeof(NodeHeader)) / (sizeof(int32_t) + sizeof(V));
+    static constexpr size_t INNER_CAPACITY = (PAGE_SIZE - sizeof(NodeHeader) - sizeof(uint32_t)) / (sizeof(int32_t) + sizeof(uint32_t));
+
+private:
+    static_assert(LEAF_CAPACITY >= 3, "value type too large for one page");
+
+    // Pinned page, unpinned when it goes out of scope
+    class PageRef
+    {
+    private:
+        BufferPool *pool;
+        uint32_t id;
+        char *bytes;
+        bool dirty;
+
+    public:
+        PageRef(BufferPool &p, uint32_t page_id, bool fresh = false)
+            : pool(&p), id(page_id), bytes(fresh ? p.create(page_id) : p.fetch(page_id)), dirty(fresh) {}
+        ~PageRef() { pool->unpin(id, dirty); }
+
+        PageRef(const PageRef &) = delete;
+        PageRef &operator=(const PageRef &) = delete;
+
+        uint32_t page_id() const { return id; }
+        void mark_dirty() { dirty = true; }
+
+        NodeHeader *header() { return reinterpret_cast<NodeHeader *>(bytes); }
+        int32_t *keys() { return reinterpret_cast<int32_t *>(bytes + sizeof(NodeHeader)); }
+
+        // leaf payload
+        char *value_at(size_t i)
+        {
+            return bytes + sizeof(NodeHeader) + LEAF_CAPACITY * sizeof(int32_t) + i * sizeof(V);
+        }
+
+        // inner children
+        uint32_t *children()
+        {
+            return reinterpret_cast<uint32_t *>(bytes + sizeof(NodeHeader) + INNER_CAPACITY * sizeof(int32_t));
+        }
+    };
+
+    PageFile file;
+    BufferPool pool;
+    FileHeader meta;
+
+    // number of keys <= key (inner routing) or < key (leaf position)
+    static size_t count_keys(const int32_t *keys, size_t n, int key, bool inclusive)
+    {
+        size_t lo = 0, hi = n;
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            bool go_right = inclusive ? keys[mid] <= key : keys[mid] < key;
+            if (go_right)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    uint32_t allocate_page() { return meta.page_count++; }
+
+    void write_header()
+    {
+        char page[PAGE_SIZE];
+        std::memset(page, 0, PAGE_SIZE);
+        std::memcpy(page, &meta, sizeof(meta));
+        file.write(0, page);
+    }
+
+public:
+    PagedBTree(const std::string &path, size_t pool_pages = 64)
+        : file(path), pool(file, pool_pages < 4 ? 4 : pool_pages), meta()
+    {
+        if (file.page_count() == 0)
+        {
+            meta.magic = MAGIC;
+            meta.page_size = PAGE_SIZE;
+            meta.value_size = sizeof(V);
+            meta.page_count = 1;
+            meta.height = 1;
+            meta.size = 0;
+            meta.root = allocate_page();
+            PageRef root(pool, meta.root, true);
+            root.header()->is_leaf = 1;
+            write_header();
+            return;
+        }
+
+        char page[PAGE_SIZE];
+        file.read(0, page);
+        std::memcpy(&meta, page, sizeof(meta));
+        if (meta.magic != MAGIC || meta.page_size != PAGE_SIZE || meta.value_size != sizeof(V))
+            throw std::runtime_error("PagedBTree: " + path + " is not a compatible tree file");
+    }
+
+    ~PagedBTree()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    PagedBTree(const PagedBTree &) = delete;
+    PagedBTree &operator=(const PagedBTree &) = delete;
+
+    bool find(int key, V &out)
+    {
+        uint32_t page_id = meta.root;
+        while (true)
+        {
+            PageRef node(pool, page_id);
+            NodeHeader *h = node.header();
+            if (h->is_leaf)
+            {
+                size_t pos = count_keys(node.keys(), h->count, key, false);
+                if (pos < h->count && node.keys()[pos] == key)
+                {
+                    std::memcpy(&out, node.value_at(pos), sizeof(V));
+                    return true;
+                }
+                return false;
+            }
+            page_id = node.children()[count_keys(node.keys(), h->count, key, true)];
+        }
+    }
+
+    bool contains(int key)
+    {
+        V tmp;
+        return find(key, tmp);
+    }
+
+    // Insert or overwrite
+    void insert(int key, const V &value)
+    {
+        uint32_t path[MAX_DEPTH];
+        size_t slots[MAX_DEPTH];
+        size_t depth = 0;
+
+        uint32_t page_id = meta.root;
+        while (true)
+        {
+            PageRef node(pool, page_id);
+            if (node.header()->is_leaf)
+                break;
+            size_t c = count_keys(node.keys(), node.header()->count, key, true);
+            if (depth == MAX_DEPTH)
+                throw std::length_error("PagedBTree: maximum depth exceeded");
+            path[depth] = page_id;
+            slots[depth] = c;
+            depth++;
+            page_id = node.children()[c];
+        }
+
+        int32_t separator;
+        uint32_t new_page;
+        {
+            PageRef leaf(pool, page_id);
+            NodeHeader *h = leaf.header();
+            int32_t *keys = leaf.keys();
+            size_t pos = count_keys(keys, h->count, key, false);
+            leaf.mark_dirty();
+
+            if (pos < h->count && keys[pos] == key)
+            {
+                std::memcpy(leaf.value_at(pos), &value, sizeof(V));
+                return;
+            }
+            meta.size++;
+
+            if (h->count < LEAF_CAPACITY)
+            {
+                std::memmove(keys + pos + 1, keys + pos, (h->count - pos) * sizeof(int32_t));
+                std::memmove(leaf.value_at(pos + 1), leaf.value_at(pos), (h->count - pos) * sizeof(V));
+                keys[pos] = key;
+                std::memcpy(leaf.value_at(pos), &value, sizeof(V));
+                h->count++;
+                return;
+            }
+
+            // split: the upper half moves to a new right sibling
+            new_page = allocate_page();
+            PageRef right(pool, new_page, true);
+            NodeHeader *rh = right.header();
+            rh->is_leaf = 1;
+
+            size_t half = (LEAF_CAPACITY + 1) / 2;
+            size_t total = LEAF_CAPACITY + 1;
+            // walk the merged sequence (old keys + new key) from the top down
+            for (size_t dst = total; dst-- > 0;)
+            {
+                int32_t k;
+                char v[sizeof(V)];
+                if (dst == pos)
+                {
+                    k = key;
+                    std::memcpy(v, &value, sizeof(V));
+                }
+                else
+                {
+                    size_t src = dst > pos ? dst - 1 : dst;
+                    k = keys[src];
+                    std::memcpy(v, leaf.value_at(src), sizeof(V));
+                }
+                if (dst >= half)
+                {
+                    right.keys()[dst - half] = k;
+                    std::memcpy(right.value_at(dst - half), v, sizeof(V));
+                }
+                else
+                {
+                    keys[dst] = k;
+                    std::memcpy(leaf.value_at(dst), v, sizeof(V));
+                }
+            }
+            h->count = static_cast<uint16_t>(half);
+            rh->count = static_cast<uint16_t>(total - half);
+            rh->next = h->next;
+            h->next = new_page;
+            separator = right.keys()[0];
+        }
+
+        // push the separator up, splitting inner pages as needed
+        while (depth > 0)
+        {
+            depth--;
+            PageRef parent(pool, path[depth]);
+            NodeHeader *h = parent.header();
+            int32_t *keys = parent.keys();
+            uint32_t *kids = parent.children();
+            size_t c = slots[depth];
+            parent.mark_dirty();
+
+            if (h->count < INNER_CAPACITY)
+            {
+                std::memmove(keys + c + 1, keys + c, (h->count - c) * sizeof(int32_t));
+                std::memmove(kids + c + 2, kids + c + 1, (h->count - c) * sizeof(uint32_t));
+                keys[c] = separator;
+                kids[c + 1] = new_page;
+                h->count++;
+                return;
+            }
+
+            // merged view of INNER_CAPACITY + 1 keys / + 2 children
+            int32_t all_keys[INNER_CAPACITY + 1];
+            uint32_t all_kids[INNER_CAPACITY + 2];
+            for (size_t j = 0, s = 0; j <= INNER_CAPACITY; ++j)
+                all_keys[j] = j == c ? separator : keys[s++];
+            for (size_t j = 0, s = 0; j <= INNER_CAPACITY + 1; ++j)
+                all_kids[j] = j == c + 1 ? new_page : kids[s++];
+
+            size_t mid = (INNER_CAPACITY + 1) / 2;
+            uint32_t sibling_page = allocate_page();
+            PageRef sibling(pool, sibling_page, true);
+            NodeHeader *sh = sibling.header();
+
+            h->count = static_cast<uint16_t>(mid);
+            std::memcpy(keys, all_keys, mid * sizeof(int32_t));
+            std::memcpy(kids, all_kids, (mid + 1) * sizeof(uint32_t));
+
+            sh->count = static_cast<uint16_t>(INNER_CAPACITY - mid);
+            std::memcpy(sibling.keys(), all_keys + mid + 1, sh->count * sizeof(int32_t));
+            std::memcpy(sibling.children(), all_kids + mid + 1, (sh->count + 1) * sizeof(uint32_t));
+
+            separator = all_keys[mid];
+            new_page = sibling_page;
+        }
+
+        // the root itself was split
+        uint32_t root_page = allocate_page();
+        PageRef root(pool, root_page, true);
+        root.header()->count = 1;
+        root.keys()[0] = separator;
+        root.children()[0] = meta.root;
+        root.children()[1] = new_page;
+        meta.root = root_page;
+        meta.height++;
+    }
+
+    // Write back dirty pages and the header; throws std::runtime_error on I/O failure
+    void flush()
+    {
+        pool.flush_all();
+        write_header();
+        file.sync();
+    }
+
+    size_t get_size() const { return meta.size; }
+    size_t get_height() const { return meta.height; }
+    size_t get_page_count() const { return meta.page_count; }
+    CacheStats get_pool_statistics() const { return pool.get_statistics(); }
+    size_t get_disk_reads() const { return file.get_reads(); }
+};
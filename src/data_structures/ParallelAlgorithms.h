@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Sequence.h"
+#include "ThreadPool.h"
+
+/*
+ * Parallel counterparts of the usual algorithms over Sequence, running on a
+ * ThreadPool (the global one by default). Work is cut into pieces of
+ * pool.default_grain(n) elements; inputs shorter than one grain run serially
+ * on the calling thread.
+ */
+
+// fn(element) for every element
+template <typename T, typename Fn>
+void parallel_for_each(Sequence<T> &seq, Fn fn, ThreadPool &pool = ThreadPool::global())
+{
+    T *data = seq.begin();
+    pool.parallel_for(0, seq.get_size(), pool.default_grain(seq.get_size()), [data, &fn](size_t lo, size_t hi)
+                      {
+        for (size_t i = lo; i < hi; ++i)
+            fn(data[i]); });
+}
+
+// Sequence of fn(element), in the same order
+template <typename T, typename Fn>
+auto parallel_transform(const Sequence<T> &seq, Fn fn, ThreadPool &pool = ThreadPool::global())
+    -> Sequence<typename std::decay<decltype(fn(std::declval<const T &>()))>::type>
+{
+    using U = typename std::decay<decltype(fn(std::declval<const T &>()))>::type;
+    size_t n = seq.get_size();
+    Sequence<U> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        result.emplace_back();
+
+    const T *in = seq.begin();
+    U *out = result.begin();
+    pool.parallel_for(0, n, pool.default_grain(n), [in, out, &fn](size_t lo, size_t hi)
+                      {
+        for (size_t i = lo; i < hi; ++i)
+            out[i] = fn(in[i]); });
+    return result;
+}
+
+// init op f(e0) op f(e1) op ...; `op` must be associative (pieces are combined in order)
+template <typename T, typename U, typename Op, typename Transform>
+U parallel_transform_reduce(const Sequence<T> &seq, U init, Op op, Transform f, ThreadPool &pool = ThreadPool::global())
+{
+    size_t n = seq.get_size();
+    if (n == 0)
+        return init;
+
+    size_t grain = pool.default_grain(n);
+    size_t pieces = (n + grain - 1) / grain;
+    std::vector<U> partial(pieces);
+    const T *data = seq.begin();
+
+    pool.parallel_for(0, pieces, 1, [&](size_t plo, size_t phi)
+                      {
+        for (size_t p = plo; p < phi; ++p)
+        {
+            size_t lo = p * grain, hi = std::min(n, lo + grain);
+            U acc = f(data[lo]);
+            for (size_t i = lo + 1; i < hi; ++i)
+                acc = op(acc, f(data[i]));
+            partial[p] = acc;
+        } });
+
+    U result = init;
+    for (const U &v : partial)
+        result = op(result, v);
+    return result;
+}
+
+// init op e0 op e1 op ...; `op` must be associative
+template <typename T, typename U, typename Op>
+U parallel_reduce(const Sequence<T> &seq, U init, Op op, ThreadPool &pool = ThreadPool::global())
+{
+    return parallel_transform_reduce(
+        seq, init, op, [](const T &value)
+        { return static_cast<U>(value); },
+        pool);
+}
+
+// Index of the first element matching pred, -1 if none (like Sequence::find)
+template <typename T, typename Pred>
+int parallel_find_if(const Sequence<T> &seq, Pred pred, ThreadPool &pool = ThreadPool::global())
+{
+    size_t n = seq.get_size();
+    std::atomic<size_t> best(n);
+    const T *data = seq.begin();
+
+    pool.parallel_for(0, n, pool.default_grain(n), [&](size_t lo, size_t hi)
+                      {
+        for (size_t i = lo; i < hi; ++i)
+        {
+            // a match further left has already been found
+            if (i >= best.load(std::memory_order_relaxed))
+                return;
+            if (pred(data[i]))
+            {
+                size_t cur = best.load(std::memory_order_relaxed);
+                while (i < cur && !best.compare_exchange_weak(cur, i))
+                {
+                }
+                return;
+            }
+        } });
+
+    size_t found = best.load();
+    return found == n ? -1 : static_cast<int>(found);
+}
+
+// Number of elements taken from `a` among the first k of the stable merge of
+// a[0, na) and b[0, nb) (ties come from `a`, like std::merge)
+template <typename T, typename Compare>
+size_t merge_co_rank(const T *a, size_t na, const T *b, size_t nb, size_t k, Compare &comp)
+{
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = std::min(k, na);
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2;
+        // a[i] belongs to the first k unless b[k - i - 1] is strictly smaller
+        if (!comp(b[k - i - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+// Sort pieces in parallel, then merge them pairwise. Each round cuts the
+// output into grain-sized slices (split points found by merge_co_rank), so
+// the last rounds, with only a few large merges, still use every thread.
+template <typename T, typename Compare = std::less<T>>
+void parallel_sort(Sequence<T> &seq, Compare comp = Compare(), ThreadPool &pool = ThreadPool::global())
+{
+    size_t n = seq.get_size();
+    size_t grain = pool.default_grain(n, 16384);
+    if (n <= grain)
+    {
+        std::sort(seq.begin(), seq.end(), comp);
+        return;
+    }
+
+    size_t pieces = (n + grain - 1) / grain;
+    T *data = seq.begin();
+    pool.parallel_for(0, pieces, 1, [&](size_t plo, size_t phi)
+                      {
+        for (size_t p = plo; p < phi; ++p)
+            std::sort(data + p * grain, data + std::min(n, (p + 1) * grain), comp); });
+
+    Sequence<T> buffer;
+    buffer.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        buffer.emplace_back();
+
+    // pairs start at multiples of 2 * width, a multiple of grain, so every
+    // grain-sized output slice lies inside one pair
+    Sequence<size_t> split;
+    split.reserve(pieces);
+    for (size_t i = 0; i < pieces; ++i)
+        split.push_back(0);
+    size_t *taken = split.begin(); // elements slice i takes from the left run before it starts
+
+    T *src = data;
+    T *dst = buffer.begin();
+    for (size_t width = grain; width < n; width *= 2)
+    {
+        // all split points first: the merges below move elements out of src
+        pool.parallel_for(0, pieces, 1, [&](size_t slo, size_t shi)
+                          {
+            for (size_t sl = slo; sl < shi; ++sl)
+            {
+                size_t pair_lo = sl * grain - sl * grain % (2 * width);
+                size_t mid = std::min(n, pair_lo + width);
+                size_t pair_hi = std::min(n, pair_lo + 2 * width);
+                taken[sl] = merge_co_rank(src + pair_lo, mid - pair_lo, src + mid, pair_hi - mid,
+                                          sl * grain - pair_lo, comp);
+            } });
+
+        pool.parallel_for(0, pieces, 1, [&](size_t slo, size_t shi)
+                          {
+            for (size_t sl = slo; sl < shi; ++sl)
+            {
+                size_t lo = sl * grain, hi = std::min(n, lo + grain);
+                size_t pair_lo = lo - lo % (2 * width);
+                size_t mid = std::min(n, pair_lo + width);
+                size_t pair_hi = std::min(n, pair_lo + 2 * width);
+                size_t k0 = lo - pair_lo, k1 = hi - pair_lo;
+                size_t i0 = taken[sl];
+                size_t i1 = hi == pair_hi ? mid - pair_lo : taken[sl + 1];
+                std::merge(std::make_move_iterator(src + pair_lo + i0), std::make_move_iterator(src + pair_lo + i1),
+                           std::make_move_iterator(src + mid + (k0 - i0)), std::make_move_iterator(src + mid + (k1 - i1)),
+                           dst + lo, comp);
+            } });
+        std::swap(src, dst);
+    }
+
+    if (src != data)
+        std::move(src, src + n, data);
+}
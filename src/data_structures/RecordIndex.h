@@ -0,0 +1,112 @@
+#pragma once
+
+#include "BTree.h"
+#include "Sequence.h"
+#include <cstddef>
+
+// Key used to index a record: `id` member by default, the value itself for int
+template <typename T>
+struct RecordKey
+{
+    static int get(const T &value) { return value.id; }
+};
+
+template <>
+struct RecordKey<int>
+{
+    static int get(const int &value) { return value; }
+};
+
+/**
+ * @brief BTree index over keys only, with records kept in a separate heap.
+ *
+ * Index nodes hold (key, slot) pairs, so splits and in-node shifts move two
+ * integers regardless of sizeof(T). Records are appended to `heap`; slots
+ * freed by erase() are reused by later inserts.
+ * Pointers returned by search() are invalidated by the next insert.
+ */
+template <typename T>
+class RecordIndex
+{
+private:
+    struct IndexEntry
+    {
+        int key;
+        size_t slot;
+
+        IndexEntry() : key(0), slot(0) {}
+        IndexEntry(int k, size_t s = 0) : key(k), slot(s) {}
+
+        bool operator<(const IndexEntry &other) const { return key < other.key; }
+        bool operator>(const IndexEntry &other) const { return key > other.key; }
+        bool operator==(const IndexEntry &other) const { return key == other.key; }
+    };
+
+    BTree<IndexEntry> index;
+    Sequence<T> heap;
+    Sequence<size_t> free_slots;
+
+public:
+    // Insert or overwrite the record with the same key
+    void insert(const T &value)
+    {
+        int key = RecordKey<T>::get(value);
+        IndexEntry *existing = index.search(IndexEntry(key));
+        if (existing)
+        {
+            heap[existing->slot] = value;
+            return;
+        }
+
+        size_t slot;
+        if (!free_slots.is_empty())
+        {
+            slot = free_slots[free_slots.get_size() - 1];
+            free_slots.pop_back();
+            heap[slot] = value;
+        }
+        else
+        {
+            slot = heap.get_size();
+            heap.push_back(value);
+        }
+        index.insert(IndexEntry(key, slot));
+    }
+
+    T *search(int key)
+    {
+        IndexEntry *e = index.search(IndexEntry(key));
+        return e ? &heap[e->slot] : nullptr;
+    }
+
+    const T *search(int key) const
+    {
+        IndexEntry *e = index.search(IndexEntry(key));
+        return e ? &heap[e->slot] : nullptr;
+    }
+
+    bool contains(int key) const { return index.contains(IndexEntry(key)); }
+
+    bool erase(int key)
+    {
+        IndexEntry *e = index.search(IndexEntry(key));
+        if (!e)
+            return false;
+        size_t slot = e->slot;
+        index.erase(IndexEntry(key));
+        heap[slot] = T();
+        free_slots.push_back(slot);
+        return true;
+    }
+
+    void clear()
+    {
+        index.clear();
+        heap.clear();
+        free_slots.clear();
+    }
+
+    size_t get_size() const { return index.get_size(); }
+    size_t index_memory_bytes() const { return index.memory_bytes(); }
+    size_t heap_memory_bytes() const { return heap.get_capacity() * sizeof(T); }
+};
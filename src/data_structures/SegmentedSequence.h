@@ -0,0 +1,216 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Sequence.h"
+
+/**
+ * @brief Append-only sequence stored in fixed-size chunks.
+ *
+ * Elements live in chunks of CHUNK slots; a directory of chunk pointers
+ * maps index i to chunk i / CHUNK, slot i % CHUNK (a shift and a mask).
+ * Growing allocates one more chunk and never moves existing elements, so
+ * pointers and references stay valid until the element is removed, and
+ * the peak footprint is the data plus one chunk instead of the 3x of a
+ * doubling array. Only the directory (one pointer per chunk) is ever
+ * reallocated.
+ *
+ * There is no insert/erase in the middle: that would break address
+ * stability. Elements are added with push_back/emplace_back and removed
+ * with pop_back or clear.
+ */
+template <typename T, size_t CHUNK = 4096>
+class SegmentedSequence
+{
+    static_assert(CHUNK > 0 && (CHUNK & (CHUNK - 1)) == 0, "chunk size must be a power of two");
+
+private:
+    static constexpr size_t log2(size_t v) { return v <= 1 ? 0 : 1 + log2(v / 2); }
+    static constexpr size_t SHIFT = log2(CHUNK);
+    static constexpr size_t MASK = CHUNK - 1;
+
+    Sequence<T *> chunks;
+    size_t size;
+
+    T *slot(size_t index) { return chunks.begin()[index >> SHIFT] + (index & MASK); }
+    const T *slot(size_t index) const { return chunks.begin()[index >> SHIFT] + (index & MASK); }
+
+    void add_chunk()
+    {
+        chunks.push_back(static_cast<T *>(::operator new(CHUNK * sizeof(T))));
+    }
+
+    void release_chunks()
+    {
+        for (size_t i = 0; i < chunks.get_size(); ++i)
+            ::operator delete(static_cast<void *>(chunks[i]));
+        chunks.clear();
+    }
+
+    void destroy_all()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            for (size_t i = 0; i < size; ++i)
+                slot(i)->~T();
+        size = 0;
+    }
+
+public:
+    template <bool CONST>
+    class basic_iterator
+    {
+    private:
+        using Owner = typename std::conditional<CONST, const SegmentedSequence, SegmentedSequence>::type;
+        Owner *owner;
+        size_t index;
+
+    public:
+        using value_type = T;
+        using reference = typename std::conditional<CONST, const T &, T &>::type;
+
+        basic_iterator(Owner *o, size_t i) : owner(o), index(i) {}
+
+        reference operator*() const { return *owner->slot(index); }
+        auto operator->() const { return owner->slot(index); }
+
+        basic_iterator &operator++()
+        {
+            ++index;
+            return *this;
+        }
+
+        bool operator==(const basic_iterator &other) const { return index == other.index; }
+        bool operator!=(const basic_iterator &other) const { return index != other.index; }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    SegmentedSequence() : size(0) {}
+
+    ~SegmentedSequence()
+    {
+        destroy_all();
+        release_chunks();
+    }
+
+    SegmentedSequence(const SegmentedSequence &other) : size(0)
+    {
+        reserve(other.size);
+        for (size_t i = 0; i < other.size; ++i)
+            push_back(other[i]);
+    }
+
+    SegmentedSequence(SegmentedSequence &&other) noexcept
+        : chunks(std::move(other.chunks)), size(other.size)
+    {
+        other.size = 0;
+    }
+
+    SegmentedSequence &operator=(const SegmentedSequence &other)
+    {
+        if (this != &other)
+        {
+            SegmentedSequence copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    SegmentedSequence &operator=(SegmentedSequence &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy_all();
+            release_chunks();
+            chunks = std::move(other.chunks);
+            size = other.size;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    // Replace the contents with a copy of `data`
+    void assign(const Sequence<T> &data)
+    {
+        clear();
+        reserve(data.get_size());
+        for (size_t i = 0; i < data.get_size(); ++i)
+            push_back(data[i]);
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (size == chunks.get_size() * CHUNK)
+            add_chunk();
+        T *p = slot(size);
+        ::new (static_cast<void *>(p)) T(std::forward<Args>(args)...);
+        size++;
+        return *p;
+    }
+
+    void pop_back()
+    {
+        if (size > 0)
+        {
+            size--;
+            slot(size)->~T();
+        }
+    }
+
+    // Allocate chunks for `n` elements up front
+    void reserve(size_t n)
+    {
+        while (chunks.get_size() * CHUNK < n)
+            add_chunk();
+    }
+
+    // Free chunks past the last element
+    void shrink_to_fit()
+    {
+        size_t needed = (size + CHUNK - 1) / CHUNK;
+        while (chunks.get_size() > needed)
+        {
+            ::operator delete(static_cast<void *>(chunks[chunks.get_size() - 1]));
+            chunks.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        destroy_all();
+        release_chunks();
+    }
+
+    T &operator[](size_t index)
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return *slot(index);
+    }
+
+    const T &operator[](size_t index) const
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return *slot(index);
+    }
+
+    size_t get_size() const { return size; }
+    size_t get_capacity() const { return chunks.get_size() * CHUNK; }
+    bool is_empty() const { return size == 0; }
+    static constexpr size_t chunk_size() { return CHUNK; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size); }
+};
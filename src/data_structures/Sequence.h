@@ -2,7 +2,21 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <new>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include "SimdSearch.h"
 
+/**
+ * @brief Dynamic array over raw (uninitialized) storage.
+ *
+ * Only the first `size` slots hold constructed objects. Growth moves the
+ * elements into the new buffer (copies them if the move could throw), so
+ * a growing Sequence<Person> does not re-allocate the strings it holds.
+ * No memory is allocated until the first element is added.
+ */
 template <typename T>
 class Sequence
 {
@@ -12,39 +26,143 @@ private:
     size_t capacity;
     static constexpr size_t INITIAL_CAPACITY = 16;
 
-    void resize(size_t new_capacity)
+    static T *allocate(size_t n)
     {
-        if (new_capacity < INITIAL_CAPACITY)
-            new_capacity = INITIAL_CAPACITY;
+        return n ? static_cast<T *>(::operator new(n * sizeof(T))) : nullptr;
+    }
+
+    static void deallocate(T *p)
+    {
+        ::operator delete(static_cast<void *>(p));
+    }
 
-        T *new_data = new T[new_capacity];
+    static void destroy(T *first, T *last)
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            for (; first != last; ++first)
+                first->~T();
+    }
 
-        if (data != nullptr && size > 0)
+    // Move elements into fresh storage, or copy them when moving may throw
+    static void relocate(T *from, size_t n, T *to)
+    {
+        if (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+            std::uninitialized_move(from, from + n, to);
+        else
+            std::uninitialized_copy(from, from + n, to);
+    }
+
+    void reallocate(size_t new_capacity)
+    {
+        T *new_data = allocate(new_capacity);
+        try
+        {
+            relocate(data, size, new_data);
+        }
+        catch (...)
         {
-            std::copy(data, data + size, new_data);
+            deallocate(new_data);
+            throw;
         }
+        destroy(data, data + size);
+        deallocate(data);
+        data = new_data;
+        capacity = new_capacity;
+    }
+
+    size_t grown_capacity() const
+    {
+        return capacity < INITIAL_CAPACITY ? INITIAL_CAPACITY : capacity * 2;
+    }
+
+    void shrink_if_sparse()
+    {
+        if (capacity > INITIAL_CAPACITY && size < capacity / 4)
+            reallocate(capacity / 2);
+    }
 
-        delete[] data;
+    // Grow and construct the new last element in one step: the arguments may
+    // refer to an element of this sequence, so it is built before the old
+    // buffer goes away.
+    template <typename... Args>
+    T &grow_and_emplace(Args &&...args)
+    {
+        size_t new_capacity = grown_capacity();
+        T *new_data = allocate(new_capacity);
+        try
+        {
+            ::new (static_cast<void *>(new_data + size)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(new_data);
+            throw;
+        }
+        try
+        {
+            relocate(data, size, new_data);
+        }
+        catch (...)
+        {
+            new_data[size].~T();
+            deallocate(new_data);
+            throw;
+        }
+        destroy(data, data + size);
+        deallocate(data);
         data = new_data;
         capacity = new_capacity;
+        return data[size++];
     }
 
-public:
-    Sequence() : data(nullptr), size(0), capacity(0)
+    template <typename U>
+    void insert_value(size_t index, U &&value)
     {
-        resize(INITIAL_CAPACITY);
+        if (index > size)
+            throw std::out_of_range("Index out of range");
+
+        if (index == size)
+        {
+            emplace_back(std::forward<U>(value));
+            return;
+        }
+
+        // take the value first: it may live inside this sequence
+        T tmp(std::forward<U>(value));
+        if (size >= capacity)
+            reallocate(grown_capacity());
+
+        ::new (static_cast<void *>(data + size)) T(std::move(data[size - 1]));
+        std::move_backward(data + index, data + size - 1, data + size);
+        data[index] = std::move(tmp);
+        size++;
     }
 
+public:
+    Sequence() : data(nullptr), size(0), capacity(0) {}
+
     ~Sequence()
     {
-        delete[] data;
+        destroy(data, data + size);
+        deallocate(data);
     }
 
     Sequence(const Sequence &other) : data(nullptr), size(0), capacity(0)
     {
-        resize(other.capacity);
+        if (other.size == 0)
+            return;
+        data = allocate(other.size);
+        try
+        {
+            std::uninitialized_copy(other.data, other.data + other.size, data);
+        }
+        catch (...)
+        {
+            deallocate(data);
+            throw;
+        }
         size = other.size;
-        std::copy(other.data, other.data + other.size, data);
+        capacity = other.size;
     }
 
     Sequence(Sequence &&other) noexcept
@@ -59,9 +177,8 @@ public:
     {
         if (this != &other)
         {
-            resize(other.capacity);
-            size = other.size;
-            std::copy(other.data, other.data + other.size, data);
+            Sequence copy(other);
+            *this = std::move(copy);
         }
         return *this;
     }
@@ -70,7 +187,8 @@ public:
     {
         if (this != &other)
         {
-            delete[] data;
+            destroy(data, data + size);
+            deallocate(data);
 
             data = other.data;
             size = other.size;
@@ -83,14 +201,18 @@ public:
         return *this;
     }
 
-    void push_back(const T &value)
-    {
-        if (capacity == 0)
-            resize(INITIAL_CAPACITY);
+    void push_back(const T &value) { emplace_back(value); }
 
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    // Construct the element in place; returns a reference to it
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
         if (size >= capacity)
-            resize(capacity * 2);
-        data[size++] = value;
+            return grow_and_emplace(std::forward<Args>(args)...);
+        ::new (static_cast<void *>(data + size)) T(std::forward<Args>(args)...);
+        return data[size++];
     }
 
     void pop_back()
@@ -98,42 +220,46 @@ public:
         if (size > 0)
         {
             size--;
-            if (capacity > INITIAL_CAPACITY && size < capacity / 4)
-                resize(capacity / 2);
+            data[size].~T();
+            shrink_if_sparse();
         }
     }
 
-    void insert(size_t index, const T &value)
-    {
-        if (index > size)
-            throw std::out_of_range("Index out of range");
+    void insert(size_t index, const T &value) { insert_value(index, value); }
 
-        if (size >= capacity)
-            resize(capacity * 2);
-
-        for (size_t i = size; i > index; --i)
-            data[i] = data[i - 1];
-
-        data[index] = value;
-        size++;
-    }
+    void insert(size_t index, T &&value) { insert_value(index, std::move(value)); }
 
     void erase(size_t index)
     {
         if (index >= size)
             throw std::out_of_range("Index out of range");
 
-        for (size_t i = index; i < size - 1; ++i)
-            data[i] = data[i + 1];
-
+        std::move(data + index + 1, data + size, data + index);
         size--;
+        data[size].~T();
 
-        if (capacity > INITIAL_CAPACITY && size < capacity / 4)
-            resize(capacity / 2);
+        shrink_if_sparse();
+    }
+
+    // Make room for at least `n` elements without further reallocation
+    void reserve(size_t n)
+    {
+        if (n > capacity)
+            reallocate(n);
     }
 
+    // Release unused capacity
+    void shrink_to_fit()
+    {
+        if (capacity > size)
+            reallocate(size);
+    }
+
+    // For int and float the scans below run on SimdSearch's vector kernels
     int find(const T &value) const
     {
+        if constexpr (SimdSearch::supports<T>())
+            return SimdSearch::find(data, size, value);
         for (size_t i = 0; i < size; ++i)
         {
             if (data[i] == value)
@@ -142,11 +268,63 @@ public:
         return -1;
     }
 
+    size_t count(const T &value) const
+    {
+        if constexpr (SimdSearch::supports<T>())
+            return SimdSearch::count(data, size, value);
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+            result += data[i] == value;
+        return result;
+    }
+
+    T min_value() const
+    {
+        if (size == 0)
+            throw std::logic_error("min_value of an empty Sequence");
+        if constexpr (SimdSearch::supports<T>())
+            return SimdSearch::min_value(data, size);
+        return *std::min_element(data, data + size);
+    }
+
+    T max_value() const
+    {
+        if (size == 0)
+            throw std::logic_error("max_value of an empty Sequence");
+        if constexpr (SimdSearch::supports<T>())
+            return SimdSearch::max_value(data, size);
+        return *std::max_element(data, data + size);
+    }
+
+    // Bit i of the result is set when element i equals one of `keys`
+    Sequence<uint64_t> membership_bitmap(const Sequence<T> &keys) const
+    {
+        Sequence<uint64_t> bits;
+        size_t words = (size + 63) / 64;
+        bits.reserve(words);
+        for (size_t w = 0; w < words; ++w)
+            bits.push_back(0);
+        if constexpr (SimdSearch::supports<T>())
+        {
+            SimdSearch::membership_bitmap(data, size, keys.begin(), keys.get_size(), bits.begin());
+            return bits;
+        }
+        for (size_t i = 0; i < size; ++i)
+            if (keys.find(data[i]) >= 0)
+                bits[i / 64] |= uint64_t(1) << (i % 64);
+        return bits;
+    }
+
     void clear()
     {
+        destroy(data, data + size);
         size = 0;
         if (capacity > INITIAL_CAPACITY)
-            resize(INITIAL_CAPACITY);
+        {
+            deallocate(data);
+            data = nullptr;
+            capacity = 0;
+        }
     }
 
     T &operator[](size_t index)
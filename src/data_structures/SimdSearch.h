@@ -0,0 +1,384 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define SIMD_SEARCH_X86 1
+#include <immintrin.h>
+#define SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Vectorised scans over arrays of int or float.
+ *
+ * find / count / min / max and a membership bitmap, each with an AVX2
+ * kernel (8 lanes), an SSE2 kernel (4 lanes) and a scalar loop. The kernel
+ * is picked at run time from what the CPU supports, so one binary built
+ * without -mavx2 still uses AVX2 where it is available. SSE2 is part of
+ * x86-64; other targets and compilers get the scalar loops.
+ *
+ * Comparisons follow operator== / operator<: a NaN never matches, and the
+ * result of min/max is unspecified when the data contains NaN.
+ */
+class SimdSearch
+{
+public:
+    template <typename T>
+    static constexpr bool supports() { return std::is_same<T, int>::value || std::is_same<T, float>::value; }
+
+    // Best level this CPU can run
+    static SimdLevel detected_level()
+    {
+#ifdef SIMD_SEARCH_X86
+        static const SimdLevel detected = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+        return detected;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    // Level the kernels currently dispatch to
+    static SimdLevel level() { return static_cast<SimdLevel>(active().load(std::memory_order_relaxed)); }
+
+    // Cap the level (for tests and benchmarks); never goes above detected_level()
+    static void set_level(SimdLevel requested)
+    {
+        SimdLevel l = requested < detected_level() ? requested : detected_level();
+        active().store(static_cast<int>(l), std::memory_order_relaxed);
+    }
+
+    static const char *level_name(SimdLevel l)
+    {
+        switch (l)
+        {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+        }
+    }
+
+    // Index of the first element equal to `value`, -1 if none
+    template <typename T>
+    static int find(const T *data, size_t n, T value)
+    {
+        static_assert(supports<T>(), "SimdSearch works on int and float");
+        size_t i = 0;
+#ifdef SIMD_SEARCH_X86
+        SimdLevel l = level();
+        if (l == SimdLevel::AVX2)
+            i = find_avx2(data, n, value);
+        else if (l == SimdLevel::SSE2)
+            i = find_sse2(data, n, value);
+#endif
+        for (; i < n; ++i)
+        {
+            if (data[i] == value)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Number of elements equal to `value`
+    template <typename T>
+    static size_t count(const T *data, size_t n, T value)
+    {
+        static_assert(supports<T>(), "SimdSearch works on int and float");
+        size_t result = 0;
+        size_t i = 0;
+#ifdef SIMD_SEARCH_X86
+        SimdLevel l = level();
+        if (l == SimdLevel::AVX2)
+            i = count_avx2(data, n, value, result);
+        else if (l == SimdLevel::SSE2)
+            i = count_sse2(data, n, value, result);
+#endif
+        for (; i < n; ++i)
+            result += data[i] == value;
+        return result;
+    }
+
+    template <typename T>
+    static T min_value(const T *data, size_t n)
+    {
+        static_assert(supports<T>(), "SimdSearch works on int and float");
+        if (n == 0)
+            throw std::logic_error("min_value of an empty range");
+        T result = data[0];
+        size_t i = 0;
+#ifdef SIMD_SEARCH_X86
+        SimdLevel l = level();
+        if (l == SimdLevel::AVX2)
+            i = min_max_avx2<false>(data, n, result);
+        else if (l == SimdLevel::SSE2)
+            i = min_max_sse2<false>(data, n, result);
+#endif
+        for (; i < n; ++i)
+            result = data[i] < result ? data[i] : result;
+        return result;
+    }
+
+    template <typename T>
+    static T max_value(const T *data, size_t n)
+    {
+        static_assert(supports<T>(), "SimdSearch works on int and float");
+        if (n == 0)
+            throw std::logic_error("max_value of an empty range");
+        T result = data[0];
+        size_t i = 0;
+#ifdef SIMD_SEARCH_X86
+        SimdLevel l = level();
+        if (l == SimdLevel::AVX2)
+            i = min_max_avx2<true>(data, n, result);
+        else if (l == SimdLevel::SSE2)
+            i = min_max_sse2<true>(data, n, result);
+#endif
+        for (; i < n; ++i)
+            result = result < data[i] ? data[i] : result;
+        return result;
+    }
+
+    /**
+     * Set bit i of `bits` when data[i] equals one of keys[0..k). `bits` must
+     * hold (n + 63) / 64 words; they are overwritten, not or-ed.
+     */
+    template <typename T>
+    static void membership_bitmap(const T *data, size_t n, const T *keys, size_t k, uint64_t *bits)
+    {
+        static_assert(supports<T>(), "SimdSearch works on int and float");
+        size_t i = 0;
+#ifdef SIMD_SEARCH_X86
+        SimdLevel l = level();
+        if (l == SimdLevel::AVX2)
+            i = bitmap_avx2(data, n, keys, k, bits);
+        else if (l == SimdLevel::SSE2)
+            i = bitmap_sse2(data, n, keys, k, bits);
+#endif
+        // the kernels stop on a word boundary
+        for (size_t w = i / 64; w < (n + 63) / 64; ++w)
+            bits[w] = 0;
+        for (; i < n; ++i)
+        {
+            for (size_t j = 0; j < k; ++j)
+            {
+                if (data[i] == keys[j])
+                {
+                    bits[i / 64] |= uint64_t(1) << (i % 64);
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    static std::atomic<int> &active()
+    {
+        static std::atomic<int> l(static_cast<int>(detected_level()));
+        return l;
+    }
+
+#ifdef SIMD_SEARCH_X86
+    // Lane helpers, overloaded on the element type. Each kernel below returns
+    // the index where it stopped; the caller finishes the tail with scalar code.
+
+    static __m128i sse2_splat(int v) { return _mm_set1_epi32(v); }
+    static __m128 sse2_splat(float v) { return _mm_set1_ps(v); }
+    static __m128i sse2_load(const int *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static __m128 sse2_load(const float *p) { return _mm_loadu_ps(p); }
+    static unsigned sse2_eq(__m128i a, __m128i b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+    static unsigned sse2_eq(__m128 a, __m128 b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+    static __m128 sse2_min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+    static __m128 sse2_max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+    // SSE2 has no 32-bit integer min/max (that is SSE4.1): select through a compare mask
+    static __m128i sse2_min(__m128i a, __m128i b)
+    {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+    }
+    static __m128i sse2_max(__m128i a, __m128i b)
+    {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+    }
+    static void sse2_store(int *p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static void sse2_store(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+
+    SIMD_AVX2 static __m256i avx2_splat(int v) { return _mm256_set1_epi32(v); }
+    SIMD_AVX2 static __m256 avx2_splat(float v) { return _mm256_set1_ps(v); }
+    SIMD_AVX2 static __m256i avx2_load(const int *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    SIMD_AVX2 static __m256 avx2_load(const float *p) { return _mm256_loadu_ps(p); }
+    SIMD_AVX2 static unsigned avx2_eq(__m256i a, __m256i b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+    SIMD_AVX2 static unsigned avx2_eq(__m256 a, __m256 b) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+    SIMD_AVX2 static __m256i avx2_min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+    SIMD_AVX2 static __m256i avx2_max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+    SIMD_AVX2 static __m256 avx2_min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+    SIMD_AVX2 static __m256 avx2_max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+    SIMD_AVX2 static void avx2_store(int *p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    SIMD_AVX2 static void avx2_store(float *p, __m256 v) { _mm256_storeu_ps(p, v); }
+
+    template <typename T>
+    static size_t find_sse2(const T *data, size_t n, T value)
+    {
+        auto needle = sse2_splat(value);
+        size_t i = 0;
+        // 16 elements per step, one branch for all four compares
+        for (; i + 16 <= n; i += 16)
+        {
+            unsigned m = sse2_eq(sse2_load(data + i), needle) | sse2_eq(sse2_load(data + i + 4), needle) << 4 |
+                         sse2_eq(sse2_load(data + i + 8), needle) << 8 | sse2_eq(sse2_load(data + i + 12), needle) << 12;
+            if (m)
+                return i + static_cast<size_t>(__builtin_ctz(m));
+        }
+        for (; i + 4 <= n; i += 4)
+        {
+            unsigned m = sse2_eq(sse2_load(data + i), needle);
+            if (m)
+                return i + static_cast<size_t>(__builtin_ctz(m));
+        }
+        return i;
+    }
+
+    template <typename T>
+    SIMD_AVX2 static size_t find_avx2(const T *data, size_t n, T value)
+    {
+        auto needle = avx2_splat(value);
+        size_t i = 0;
+        // 32 elements per step, one branch for all four compares
+        for (; i + 32 <= n; i += 32)
+        {
+            unsigned m = avx2_eq(avx2_load(data + i), needle) | avx2_eq(avx2_load(data + i + 8), needle) << 8 |
+                         avx2_eq(avx2_load(data + i + 16), needle) << 16 | avx2_eq(avx2_load(data + i + 24), needle) << 24;
+            if (m)
+                return i + static_cast<size_t>(__builtin_ctz(m));
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            unsigned m = avx2_eq(avx2_load(data + i), needle);
+            if (m)
+                return i + static_cast<size_t>(__builtin_ctz(m));
+        }
+        return i;
+    }
+
+    template <typename T>
+    static size_t count_sse2(const T *data, size_t n, T value, size_t &result)
+    {
+        auto needle = sse2_splat(value);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            unsigned m = sse2_eq(sse2_load(data + i), needle) | sse2_eq(sse2_load(data + i + 4), needle) << 4 |
+                         sse2_eq(sse2_load(data + i + 8), needle) << 8 | sse2_eq(sse2_load(data + i + 12), needle) << 12;
+            result += static_cast<size_t>(__builtin_popcount(m));
+        }
+        return i;
+    }
+
+    template <typename T>
+    SIMD_AVX2 static size_t count_avx2(const T *data, size_t n, T value, size_t &result)
+    {
+        auto needle = avx2_splat(value);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            unsigned m = avx2_eq(avx2_load(data + i), needle) | avx2_eq(avx2_load(data + i + 8), needle) << 8 |
+                         avx2_eq(avx2_load(data + i + 16), needle) << 16 | avx2_eq(avx2_load(data + i + 24), needle) << 24;
+            result += static_cast<size_t>(__builtin_popcount(m));
+        }
+        return i;
+    }
+
+    // Two accumulators to hide the min/max latency; `result` comes in as data[0]
+    template <bool MAX, typename T>
+    static size_t min_max_sse2(const T *data, size_t n, T &result)
+    {
+        if (n < 8)
+            return 0;
+        auto a = sse2_load(data), b = sse2_load(data + 4);
+        size_t i = 8;
+        for (; i + 8 <= n; i += 8)
+        {
+            a = MAX ? sse2_max(a, sse2_load(data + i)) : sse2_min(a, sse2_load(data + i));
+            b = MAX ? sse2_max(b, sse2_load(data + i + 4)) : sse2_min(b, sse2_load(data + i + 4));
+        }
+        T lanes[4];
+        sse2_store(lanes, MAX ? sse2_max(a, b) : sse2_min(a, b));
+        for (T v : lanes)
+            result = MAX ? (result < v ? v : result) : (v < result ? v : result);
+        return i;
+    }
+
+    template <bool MAX, typename T>
+    SIMD_AVX2 static size_t min_max_avx2(const T *data, size_t n, T &result)
+    {
+        if (n < 16)
+            return 0;
+        auto a = avx2_load(data), b = avx2_load(data + 8);
+        size_t i = 16;
+        for (; i + 16 <= n; i += 16)
+        {
+            a = MAX ? avx2_max(a, avx2_load(data + i)) : avx2_min(a, avx2_load(data + i));
+            b = MAX ? avx2_max(b, avx2_load(data + i + 8)) : avx2_min(b, avx2_load(data + i + 8));
+        }
+        T lanes[8];
+        avx2_store(lanes, MAX ? avx2_max(a, b) : avx2_min(a, b));
+        for (T v : lanes)
+            result = MAX ? (result < v ? v : result) : (v < result ? v : result);
+        return i;
+    }
+
+    // Whole 64-element words only
+    template <typename T>
+    static size_t bitmap_sse2(const T *data, size_t n, const T *keys, size_t k, uint64_t *bits)
+    {
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            uint64_t word = 0;
+            for (size_t b = 0; b < 64; b += 4)
+            {
+                auto block = sse2_load(data + i + b);
+                unsigned m = 0;
+                for (size_t j = 0; j < k; ++j)
+                    m |= sse2_eq(block, sse2_splat(keys[j]));
+                word |= static_cast<uint64_t>(m) << b;
+            }
+            bits[i / 64] = word;
+        }
+        return i;
+    }
+
+    template <typename T>
+    SIMD_AVX2 static size_t bitmap_avx2(const T *data, size_t n, const T *keys, size_t k, uint64_t *bits)
+    {
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            uint64_t word = 0;
+            for (size_t b = 0; b < 64; b += 8)
+            {
+                auto block = avx2_load(data + i + b);
+                unsigned m = 0;
+                for (size_t j = 0; j < k; ++j)
+                    m |= avx2_eq(block, avx2_splat(keys[j]));
+                word |= static_cast<uint64_t>(m) << b;
+            }
+            bits[i / 64] = word;
+        }
+        return i;
+    }
+#endif
+};
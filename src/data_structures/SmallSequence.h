@@ -0,0 +1,256 @@
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "SimdSearch.h"
+
+/**
+ * @brief Sequence with room for N elements inside the object itself.
+ *
+ * Up to N elements live in an inline buffer and cost no heap allocation;
+ * the N+1-th element moves everything to a heap buffer that then grows like
+ * Sequence's. Meant for the many containers that usually stay tiny (hash
+ * buckets, short key lists). Same interface as Sequence.
+ */
+template <typename T, size_t N>
+class SmallSequence
+{
+    static_assert(N > 0, "SmallSequence needs at least one inline slot");
+
+private:
+    alignas(T) unsigned char inline_storage[N * sizeof(T)];
+    T *data;
+    size_t size;
+    size_t capacity;
+
+    T *inline_data() { return reinterpret_cast<T *>(inline_storage); }
+
+    static void destroy(T *first, T *last)
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            for (; first != last; ++first)
+                first->~T();
+    }
+
+    void release()
+    {
+        destroy(data, data + size);
+        if (!is_inline())
+            ::operator delete(static_cast<void *>(data));
+    }
+
+    // Move the elements to a heap buffer of `new_capacity` (or back inline if they fit)
+    void reallocate(size_t new_capacity)
+    {
+        T *new_data = new_capacity <= N ? inline_data()
+                                        : static_cast<T *>(::operator new(new_capacity * sizeof(T)));
+        if (new_data == data)
+            return;
+        try
+        {
+            if (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+                std::uninitialized_move(data, data + size, new_data);
+            else
+                std::uninitialized_copy(data, data + size, new_data);
+        }
+        catch (...)
+        {
+            if (new_data != inline_data())
+                ::operator delete(static_cast<void *>(new_data));
+            throw;
+        }
+        release();
+        data = new_data;
+        capacity = new_capacity <= N ? N : new_capacity;
+    }
+
+    template <typename U>
+    void insert_value(size_t index, U &&value)
+    {
+        if (index > size)
+            throw std::out_of_range("Index out of range");
+
+        // take the value first: it may live inside this sequence
+        T tmp(std::forward<U>(value));
+        if (size >= capacity)
+            reallocate(capacity * 2);
+
+        if (index == size)
+        {
+            ::new (static_cast<void *>(data + size)) T(std::move(tmp));
+        }
+        else
+        {
+            ::new (static_cast<void *>(data + size)) T(std::move(data[size - 1]));
+            std::move_backward(data + index, data + size - 1, data + size);
+            data[index] = std::move(tmp);
+        }
+        size++;
+    }
+
+    void take(SmallSequence &&other)
+    {
+        if (other.is_inline())
+        {
+            std::uninitialized_move(other.data, other.data + other.size, data);
+            size = other.size;
+            destroy(other.data, other.data + other.size);
+        }
+        else
+        {
+            data = other.data;
+            size = other.size;
+            capacity = other.capacity;
+            other.data = other.inline_data();
+            other.capacity = N;
+        }
+        other.size = 0;
+    }
+
+public:
+    SmallSequence() : data(inline_data()), size(0), capacity(N) {}
+
+    ~SmallSequence() { release(); }
+
+    SmallSequence(const SmallSequence &other) : SmallSequence()
+    {
+        reserve(other.size);
+        std::uninitialized_copy(other.data, other.data + other.size, data);
+        size = other.size;
+    }
+
+    SmallSequence(SmallSequence &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : SmallSequence()
+    {
+        take(std::move(other));
+    }
+
+    SmallSequence &operator=(const SmallSequence &other)
+    {
+        if (this != &other)
+        {
+            SmallSequence copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    SmallSequence &operator=(SmallSequence &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            release();
+            data = inline_data();
+            size = 0;
+            capacity = N;
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (size >= capacity)
+        {
+            // build first: the arguments may refer to an element that is about to move
+            T tmp(std::forward<Args>(args)...);
+            reallocate(capacity * 2);
+            ::new (static_cast<void *>(data + size)) T(std::move(tmp));
+        }
+        else
+            ::new (static_cast<void *>(data + size)) T(std::forward<Args>(args)...);
+        return data[size++];
+    }
+
+    void pop_back()
+    {
+        if (size > 0)
+        {
+            size--;
+            data[size].~T();
+        }
+    }
+
+    void insert(size_t index, const T &value) { insert_value(index, value); }
+
+    void insert(size_t index, T &&value) { insert_value(index, std::move(value)); }
+
+    void erase(size_t index)
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+
+        std::move(data + index + 1, data + size, data + index);
+        size--;
+        data[size].~T();
+    }
+
+    void reserve(size_t n)
+    {
+        if (n > capacity)
+            reallocate(n);
+    }
+
+    // Drop unused heap capacity; moves back inline when the elements fit
+    void shrink_to_fit()
+    {
+        if (!is_inline() && capacity > size)
+            reallocate(size);
+    }
+
+    int find(const T &value) const
+    {
+        if constexpr (SimdSearch::supports<T>())
+            return SimdSearch::find(data, size, value);
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] == value)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Destroys the elements and returns to the inline buffer
+    void clear()
+    {
+        release();
+        data = inline_data();
+        size = 0;
+        capacity = N;
+    }
+
+    T &operator[](size_t index)
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return data[index];
+    }
+
+    const T &operator[](size_t index) const
+    {
+        if (index >= size)
+            throw std::out_of_range("Index out of range");
+        return data[index];
+    }
+
+    size_t get_size() const { return size; }
+    size_t get_capacity() const { return capacity; }
+    bool is_empty() const { return size == 0; }
+    bool is_inline() const { return data == reinterpret_cast<const T *>(inline_storage); }
+    static constexpr size_t inline_capacity() { return N; }
+
+    T *begin() { return data; }
+    T *end() { return data + size; }
+    const T *begin() const { return data; }
+    const T *end() const { return data + size; }
+};
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Reusable work-stealing thread pool with fork-join parallel_for.
+ *
+ * Each worker owns a task deque: it pushes and pops its own work at the
+ * back (LIFO, cache-warm) and, when empty, steals from the front of other
+ * workers' deques (the oldest, largest pieces). A thread waiting for its
+ * subtasks keeps running queued tasks instead of blocking, so nested
+ * parallel calls cannot deadlock and the calling thread does work too.
+ */
+class ThreadPool
+{
+private:
+    using Task = std::function<void()>;
+
+    struct WorkQueue
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    // Outstanding subtasks of one parallel_for call
+    struct TaskGroup
+    {
+        std::atomic<size_t> remaining{0};
+        std::mutex error_mtx;
+        std::exception_ptr error;
+    };
+
+    // queue 0 takes work from threads outside the pool, 1..N belong to workers
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping;
+    std::atomic<size_t> queued;
+    std::mutex sleep_mtx;
+    std::condition_variable wake;
+
+    static size_t &current_queue()
+    {
+        static thread_local size_t index = 0;
+        return index;
+    }
+
+    static ThreadPool *&current_pool()
+    {
+        static thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    size_t own_queue() const { return current_pool() == this ? current_queue() : 0; }
+
+    void push(Task task)
+    {
+        WorkQueue &q = *queues[own_queue()];
+        {
+            // count before publishing: a thief's fetch_sub must never run ahead of
+            // this increment, or `queued` would wrap around. Under sleep_mtx so a
+            // worker between its check and wait() cannot miss it
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            queued.fetch_add(1, std::memory_order_release);
+        }
+        try
+        {
+            std::lock_guard<std::mutex> lock(q.mtx);
+            q.tasks.push_back(std::move(task));
+        }
+        catch (...)
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        wake.notify_one();
+    }
+
+    bool pop_own(size_t index, Task &task)
+    {
+        WorkQueue &q = *queues[index];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty())
+            return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task &task)
+    {
+        size_t n = queues.size();
+        for (size_t k = 1; k < n; ++k)
+        {
+            WorkQueue &q = *queues[(thief + k) % n];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty())
+            {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool run_one()
+    {
+        size_t me = own_queue();
+        Task task;
+        if (!pop_own(me, task) && !steal(me, task))
+            return false;
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void worker_loop(size_t index)
+    {
+        current_pool() = this;
+        current_queue() = index;
+        while (true)
+        {
+            if (run_one())
+                continue;
+            std::unique_lock<std::mutex> lock(sleep_mtx);
+            wake.wait(lock, [this]
+                      { return stopping.load() || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping.load() && queued.load() == 0)
+                return;
+        }
+    }
+
+    template <typename Fn>
+    void split(TaskGroup &group, size_t lo, size_t hi, size_t grain, const Fn &fn)
+    {
+        // hand out the upper halves, keep the lowest piece for this thread
+        while (hi - lo > grain)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            group.remaining.fetch_add(1, std::memory_order_relaxed);
+            push([this, &group, mid, hi, grain, &fn]
+                 { run_piece(group, mid, hi, grain, fn); });
+            hi = mid;
+        }
+        fn(lo, hi);
+    }
+
+    template <typename Fn>
+    void run_piece(TaskGroup &group, size_t lo, size_t hi, size_t grain, const Fn &fn)
+    {
+        try
+        {
+            split(group, lo, hi, grain, fn);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(group.error_mtx);
+            if (!group.error)
+                group.error = std::current_exception();
+        }
+        group.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+public:
+    // threads = 0 means one per hardware thread (the caller also works, see parallel_for)
+    explicit ThreadPool(size_t threads = 0) : stopping(false), queued(0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i <= threads; ++i)
+            queues.emplace_back(new WorkQueue());
+        for (size_t i = 1; i <= threads; ++i)
+            workers.emplace_back([this, i]
+                                 { worker_loop(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            stopping.store(true);
+        }
+        wake.notify_all();
+        for (auto &t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool &global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t get_thread_count() const { return workers.size(); }
+
+    // Grain size: about 8 pieces per thread so stealing can even out uneven work,
+    // but never below `min_grain` elements so task overhead stays negligible
+    size_t default_grain(size_t n, size_t min_grain = 2048) const
+    {
+        size_t pieces = (workers.size() + 1) * 8;
+        return std::max(min_grain, (n + pieces - 1) / pieces);
+    }
+
+    /**
+     * Call fn(lo, hi) over disjoint subranges covering [begin, end), each at
+     * most `grain` long, in parallel. Returns when all are done; the first
+     * exception thrown by fn is rethrown here.
+     */
+    template <typename Fn>
+    void parallel_for(size_t begin, size_t end, size_t grain, const Fn &fn)
+    {
+        if (begin >= end)
+            return;
+        if (grain == 0)
+            grain = 1;
+
+        TaskGroup group;
+        group.remaining.store(1);
+        run_piece(group, begin, end, grain, fn);
+
+        // help with queued work instead of blocking
+        while (group.remaining.load(std::memory_order_acquire) > 0)
+            if (!run_one())
+                std::this_thread::yield();
+
+        if (group.error)
+            std::rethrow_exception(group.error);
+    }
+};
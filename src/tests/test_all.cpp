@@ -3,12 +3,41 @@
 #include <random>
 #include <chrono>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <thread>
+#include <atomic>
 
 #include "test_all.h"
 #include "../cache/CacheManager.h"
+#include "../cache/DiskTier.h"
+#include "../cache/SlowStorage.h"
+#include "../cache/Person.h"
+#include "../cache/CompactPerson.h"
 #include "../data_structures/Sequence.h"
+#include "../data_structures/SimdSearch.h"
+#include "../data_structures/SmallSequence.h"
+#include "../data_structures/SegmentedSequence.h"
+#include "../data_structures/MappedSequence.h"
+#include "../data_structures/ParallelAlgorithms.h"
 #include "../data_structures/BTree.h"
+#include "../data_structures/BPlusTree.h"
+#include "../data_structures/RecordIndex.h"
+#include "../data_structures/NodePool.h"
+#include "../data_structures/InlineArray.h"
+#include "../data_structures/ConcurrentBTree.h"
+#include "../data_structures/ConcurrentDictionary.h"
+#include "../data_structures/PagedBTree.h"
+#include "../data_structures/EytzingerIndex.h"
 #include "../data_structures/Dictionary.h"
+#include "../benchmark/BenchmarkHarness.h"
+#include "../benchmark/Workload.h"
+#include "../benchmark/AccessTrace.h"
+#include "../benchmark/MemoryAccounting.h"
+#include "../benchmark/PerfCounters.h"
 
 using namespace std;
 
@@ -58,6 +87,409 @@ static void test_sequence_basic()
     cout << "Sequence basic tests: OK\n";
 }
 
+// Counts copies/moves and live objects to check Sequence's raw storage handling
+struct Tracked
+{
+    static int live;
+    static int copies;
+    int value;
+
+    Tracked(int v = 0) : value(v) { live++; }
+    Tracked(const Tracked &o) : value(o.value)
+    {
+        live++;
+        copies++;
+    }
+    Tracked(Tracked &&o) noexcept : value(o.value) { live++; }
+    Tracked &operator=(const Tracked &o)
+    {
+        value = o.value;
+        copies++;
+        return *this;
+    }
+    Tracked &operator=(Tracked &&o) noexcept
+    {
+        value = o.value;
+        return *this;
+    }
+    ~Tracked() { live--; }
+};
+int Tracked::live = 0;
+int Tracked::copies = 0;
+
+static void test_sequence_move()
+{
+    header("Sequence: move semantics and raw storage");
+
+    {
+        Sequence<Tracked> s;
+        assert(s.get_capacity() == 0); // nothing allocated up front
+        for (int i = 0; i < 1000; ++i)
+            s.push_back(Tracked(i));
+        for (int i = 0; i < 1000; ++i)
+            s.emplace_back(i);
+        // growth and rvalue push_back never copy; only constructed slots are live
+        assert(Tracked::copies == 0);
+        assert(Tracked::live == 2000);
+
+        s.insert(5, Tracked(-1));
+        s.erase(0);
+        assert(s[4].value == -1 && s.get_size() == 2000);
+        assert(Tracked::copies == 0 && Tracked::live == 2000);
+
+        // inserting an element of the sequence itself
+        s.push_back(s[0]);
+        s.insert(1, s[3]);
+        assert(s[s.get_size() - 1].value == 1 && s[1].value == 4);
+
+        while (s.get_size() > 10)
+            s.pop_back();
+        assert(Tracked::live == 10);
+        s.shrink_to_fit();
+        assert(s.get_capacity() == 10);
+
+        s.reserve(500);
+        assert(s.get_capacity() == 500 && s.get_size() == 10);
+
+        Sequence<Tracked> copy = s;
+        assert(Tracked::live == 20);
+        Sequence<Tracked> moved = std::move(copy);
+        assert(Tracked::live == 20 && copy.get_size() == 0);
+        moved.clear();
+        assert(Tracked::live == 10);
+    }
+    assert(Tracked::live == 0);
+
+    // strings survive relocation
+    Sequence<string> words;
+    for (int i = 0; i < 100; ++i)
+        words.emplace_back(30, static_cast<char>('a' + i % 26));
+    assert(words[99] == string(30, 'a' + 99 % 26));
+
+    cout << "Sequence move tests: OK\n";
+}
+
+static void test_segmented_sequence()
+{
+    header("SegmentedSequence tests");
+
+    SegmentedSequence<int, 8> s;
+    s.push_back(0);
+    int *first = &s[0];
+    for (int i = 1; i < 1000; ++i)
+        s.push_back(i);
+    // growth never moves elements
+    assert(first == &s[0] && *first == 0);
+    assert(s.get_size() == 1000 && s.get_capacity() == 1000);
+    for (int i = 0; i < 1000; ++i)
+        assert(s[i] == i);
+
+    int expected = 0;
+    for (int v : s)
+        assert(v == expected++);
+    assert(expected == 1000);
+
+    for (int i = 0; i < 995; ++i)
+        s.pop_back();
+    s.shrink_to_fit();
+    assert(s.get_size() == 5 && s.get_capacity() == 8);
+
+    bool thrown = false;
+    try
+    {
+        s[5];
+    }
+    catch (const out_of_range &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    Tracked::copies = 0;
+    {
+        SegmentedSequence<Tracked, 4> t;
+        for (int i = 0; i < 100; ++i)
+            t.emplace_back(i);
+        assert(Tracked::copies == 0 && Tracked::live == 100);
+        SegmentedSequence<Tracked, 4> copy = t;
+        assert(Tracked::live == 200 && copy[99].value == 99);
+        SegmentedSequence<Tracked, 4> moved = std::move(copy);
+        assert(Tracked::live == 200 && copy.is_empty());
+        t.clear();
+        assert(Tracked::live == 100 && t.get_capacity() == 0);
+    }
+    assert(Tracked::live == 0);
+
+    Sequence<string> words;
+    for (int i = 0; i < 50; ++i)
+        words.push_back(string(20, 'a' + i % 26));
+    SegmentedSequence<string, 16> chunked;
+    chunked.assign(words);
+    assert(chunked.get_size() == 50 && chunked[49] == words[49]);
+
+    cout << "SegmentedSequence tests: OK\n";
+}
+
+static void test_small_sequence()
+{
+    header("SmallSequence tests");
+
+    Tracked::copies = 0;
+    {
+        SmallSequence<Tracked, 4> s;
+        assert(s.is_inline() && s.get_capacity() == 4);
+        for (int i = 0; i < 4; ++i)
+            s.emplace_back(i);
+        assert(s.is_inline() && Tracked::live == 4);
+
+        // fifth element spills to the heap, moving (not copying) the rest
+        s.push_back(s[0]);
+        assert(!s.is_inline() && s.get_size() == 5 && s[4].value == 0);
+        assert(Tracked::copies == 1);
+
+        s.insert(0, Tracked(-1));
+        s.erase(3);
+        assert(s[0].value == -1 && s[3].value == 3 && s.get_size() == 5);
+
+        // copies and moves keep both representations intact
+        SmallSequence<Tracked, 4> heap_copy = s;
+        SmallSequence<Tracked, 4> inline_seq;
+        inline_seq.emplace_back(7);
+        SmallSequence<Tracked, 4> moved_inline = std::move(inline_seq);
+        assert(moved_inline.is_inline() && moved_inline[0].value == 7 && inline_seq.is_empty());
+        SmallSequence<Tracked, 4> moved_heap = std::move(heap_copy);
+        assert(!moved_heap.is_inline() && moved_heap.get_size() == 5 && heap_copy.is_inline());
+
+        while (s.get_size() > 2)
+            s.pop_back();
+        s.shrink_to_fit();
+        assert(s.is_inline() && s[1].value == 0);
+        s.clear();
+        assert(s.is_empty() && s.is_inline());
+        assert(Tracked::live == 6);
+    }
+    assert(Tracked::live == 0);
+
+    bool thrown = false;
+    try
+    {
+        SmallSequence<int, 2> s;
+        s[0];
+    }
+    catch (const out_of_range &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Dictionary with inline buckets through several rehashes, erases and overwrites
+    Dictionary<int, string> dict;
+    for (int i = 0; i < 5000; ++i)
+        dict.insert(i, to_string(i));
+    for (int i = 0; i < 5000; i += 2)
+        assert(dict.erase(i));
+    for (int i = 1; i < 5000; i += 2)
+        dict.insert(i, "v" + to_string(i));
+    assert(dict.get_size() == 2500);
+    for (int i = 0; i < 5000; ++i)
+        assert((i % 2 == 0) ? !dict.contains(i) : *dict.find(i) == "v" + to_string(i));
+
+    cout << "SmallSequence tests: OK\n";
+}
+
+static void test_parallel_algorithms()
+{
+    header("Parallel algorithms tests");
+
+    ThreadPool pool(4);
+    mt19937 gen(5);
+
+    for (int n : {0, 1, 100, 5000, 200000})
+    {
+        Sequence<int> data;
+        vector<int> expected;
+        for (int i = 0; i < n; ++i)
+        {
+            int v = static_cast<int>(gen() % 100000);
+            data.push_back(v);
+            expected.push_back(v);
+        }
+
+        long long sum = parallel_reduce(data, 0LL, [](long long a, long long b)
+                                        { return a + b; }, pool);
+        long long serial = 0;
+        for (int v : expected)
+            serial += v;
+        assert(sum == serial);
+
+        Sequence<long long> squares = parallel_transform(data, [](int v)
+                                                         { return static_cast<long long>(v) * v; }, pool);
+        assert(squares.get_size() == data.get_size());
+        for (int i = 0; i < n; ++i)
+            assert(squares[i] == static_cast<long long>(expected[i]) * expected[i]);
+
+        // first match, not just any match
+        int first = -1;
+        for (int i = 0; i < n && first < 0; ++i)
+            if (expected[i] % 1000 == 7)
+                first = i;
+        assert(parallel_find_if(data, [](int v)
+                                { return v % 1000 == 7; }, pool) == first);
+        assert(parallel_find_if(data, [](int v)
+                                { return v < 0; }, pool) == -1);
+
+        parallel_for_each(data, [](int &v)
+                          { v = -v; }, pool);
+        parallel_sort(data, less<int>(), pool);
+        sort(expected.begin(), expected.end(), greater<int>());
+        for (int i = 0; i < n; ++i)
+            assert(data[i] == -expected[i]);
+    }
+
+    // Person records: sort by age, then by id, through move-only merges
+    Sequence<Person> people;
+    for (int i = 0; i < 50000; ++i)
+        people.push_back(Person(i, "name" + to_string(i), static_cast<int>(gen() % 80), "p" + to_string(i) + "@mail.com"));
+    parallel_sort(people, [](const Person &a, const Person &b)
+                  { return a.age != b.age ? a.age < b.age : a.id < b.id; },
+                  pool);
+    for (size_t i = 1; i < people.get_size(); ++i)
+        assert(people[i - 1].age < people[i].age || (people[i - 1].age == people[i].age && people[i - 1].id < people[i].id));
+    assert(people[0].name == "name" + to_string(people[0].id));
+
+    // many ties: merges split at equal keys must neither lose nor duplicate records
+    Sequence<Person> by_age;
+    for (int i = 0; i < 100000; ++i)
+        by_age.push_back(Person(i, "name" + to_string(i), static_cast<int>(gen() % 5), ""));
+    parallel_sort(by_age, [](const Person &a, const Person &b)
+                  { return a.age < b.age; },
+                  pool);
+    vector<char> seen(by_age.get_size(), 0);
+    for (size_t i = 0; i < by_age.get_size(); ++i)
+    {
+        assert(i == 0 || by_age[i - 1].age <= by_age[i].age);
+        assert(by_age[i].name == "name" + to_string(by_age[i].id));
+        assert(!seen[by_age[i].id]);
+        seen[by_age[i].id] = 1;
+    }
+
+    // exceptions reach the caller; nested calls do not deadlock
+    bool thrown = false;
+    try
+    {
+        pool.parallel_for(0, 100000, 100, [](size_t lo, size_t)
+                          {
+            if (lo >= 50000)
+                throw runtime_error("boom"); });
+    }
+    catch (const runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    atomic<long long> nested(0);
+    pool.parallel_for(0, 64, 1, [&](size_t lo, size_t hi)
+                      {
+        for (size_t i = lo; i < hi; ++i)
+            pool.parallel_for(0, 1000, 10, [&](size_t a, size_t b)
+                              { nested += static_cast<long long>(b - a); }); });
+    assert(nested == 64 * 1000);
+
+    cout << "Parallel algorithms tests: OK\n";
+}
+
+static void test_simd_search()
+{
+    header("SIMD search tests");
+
+    mt19937 gen(11);
+    SimdLevel saved = SimdSearch::level();
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        SimdSearch::set_level(level);
+        assert(SimdSearch::level() <= SimdSearch::detected_level());
+
+        // odd sizes exercise every tail path
+        for (int n : {0, 1, 7, 33, 64, 100, 1000, 4097})
+        {
+            Sequence<int> ints;
+            Sequence<float> floats;
+            for (int i = 0; i < n; ++i)
+            {
+                ints.push_back(static_cast<int>(gen() % 50) - 25);
+                floats.push_back(static_cast<float>(gen() % 50) * 0.5f - 12.0f);
+            }
+
+            for (int v : {-25, 0, 7, 24, 100})
+            {
+                int first = -1, cnt = 0;
+                for (int i = n - 1; i >= 0; --i)
+                    if (ints[i] == v)
+                        first = i, cnt++;
+                assert(ints.find(v) == first);
+                assert(ints.count(v) == static_cast<size_t>(cnt));
+            }
+            for (float v : {-12.0f, 0.5f, 12.5f, 99.0f})
+            {
+                int first = -1, cnt = 0;
+                for (int i = n - 1; i >= 0; --i)
+                    if (floats[i] == v)
+                        first = i, cnt++;
+                assert(floats.find(v) == first);
+                assert(floats.count(v) == static_cast<size_t>(cnt));
+            }
+
+            if (n > 0)
+            {
+                assert(ints.min_value() == *min_element(ints.begin(), ints.end()));
+                assert(ints.max_value() == *max_element(ints.begin(), ints.end()));
+                assert(floats.min_value() == *min_element(floats.begin(), floats.end()));
+                assert(floats.max_value() == *max_element(floats.begin(), floats.end()));
+            }
+
+            Sequence<int> keys;
+            for (int k : {-3, 4, 11})
+                keys.push_back(k);
+            Sequence<uint64_t> bits = ints.membership_bitmap(keys);
+            assert(bits.get_size() == static_cast<size_t>((n + 63) / 64));
+            for (int i = 0; i < n; ++i)
+            {
+                bool member = ints[i] == -3 || ints[i] == 4 || ints[i] == 11;
+                assert(((bits[i / 64] >> (i % 64)) & 1) == (member ? 1u : 0u));
+            }
+        }
+
+        // extremes, and a match in the very last slot
+        Sequence<int> edge;
+        for (int i = 0; i < 40; ++i)
+            edge.push_back(0);
+        edge[39] = INT_MIN;
+        edge[17] = INT_MAX;
+        assert(edge.find(INT_MIN) == 39 && edge.min_value() == INT_MIN && edge.max_value() == INT_MAX);
+
+        SmallSequence<int, 16> small;
+        for (int i = 0; i < 20; ++i)
+            small.push_back(i * 3);
+        assert(small.find(57) == 19 && small.find(58) == -1);
+    }
+    SimdSearch::set_level(saved);
+
+    Sequence<int> empty;
+    bool thrown = false;
+    try
+    {
+        empty.min_value();
+    }
+    catch (const logic_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "SIMD search tests: OK (" << SimdSearch::level_name(SimdSearch::detected_level()) << ")\n";
+}
+
 // Dictionary tests
 static void test_dictionary_basic()
 {
@@ -91,6 +523,75 @@ static void test_dictionary_basic()
     cout << "Dictionary basic tests: OK\n";
 }
 
+static void test_dictionary_bulk()
+{
+    header("Dictionary iteration and bulk operations");
+
+    Dictionary<int, int> d;
+    assert(d.begin() == d.end());
+
+    Sequence<int> keys, values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        keys.push_back(i);
+        values.push_back(i * 10);
+    }
+    d.reserve(1000);
+    size_t reserved = d.get_capacity();
+    d.insert_bulk(keys, values);
+    assert(d.get_size() == 1000 && d.get_capacity() == reserved);
+
+    // every entry exactly once
+    long long key_sum = 0;
+    size_t visited = 0;
+    for (const auto &e : d)
+    {
+        assert(e.value == e.key * 10);
+        key_sum += e.key;
+        visited++;
+    }
+    assert(visited == 1000 && key_sum == 999LL * 1000 / 2);
+
+    // values can be updated in place
+    for (auto &e : d)
+        e.value = -e.key;
+    assert(*d.find(7) == -7);
+
+    // pairs overwrite existing keys
+    Sequence<Pair<int, int>> pairs;
+    for (int i = 990; i < 1010; ++i)
+        pairs.push_back(Pair<int, int>(i, 1));
+    d.insert_bulk(pairs);
+    assert(d.get_size() == 1010 && *d.find(995) == 1 && *d.find(1005) == 1);
+
+    size_t removed = d.erase_if([](const Pair<int, int> &e)
+                                { return e.key % 2 == 1; });
+    assert(removed == 505 && d.get_size() == 505);
+    assert(!d.contains(3) && d.contains(4));
+    visited = 0;
+    for (auto it = d.begin(); it != d.end(); ++it)
+    {
+        assert(it->key % 2 == 0);
+        visited++;
+    }
+    assert(visited == 505 && d.get_all_entries().get_size() == 505);
+
+    bool thrown = false;
+    try
+    {
+        Sequence<int> one;
+        one.push_back(1);
+        d.insert_bulk(one, Sequence<int>());
+    }
+    catch (const invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "Dictionary bulk tests: OK\n";
+}
+
 // BTree tests
 static void test_btree_basic()
 {
@@ -115,6 +616,565 @@ static void test_btree_basic()
     cout << "BTree basic tests: OK\n";
 }
 
+static void test_node_pool()
+{
+    header("NodePool & InlineArray");
+
+    struct Node
+    {
+        int value;
+        string label;
+        Node(int v) : value(v), label("node" + to_string(v)) {}
+    };
+
+    NodePool<Node, 4> pool;
+    vector<Node *> nodes;
+    for (int i = 0; i < 10; ++i)
+        nodes.push_back(pool.create(i));
+    assert(pool.get_live() == 10 && nodes[9]->label == "node9");
+
+    Node *freed = nodes[3];
+    pool.destroy(freed);
+    Node *reused = pool.create(42);
+    assert(reused == freed && reused->value == 42);
+    for (Node *n : nodes)
+        if (n != freed)
+            pool.destroy(n);
+    pool.destroy(reused);
+    assert(pool.get_live() == 0);
+
+    InlineArray<int, 3> arr;
+    arr.push_back(1);
+    arr.push_back(3);
+    arr.insert(1, 2);
+    assert(arr.get_size() == 3 && arr[1] == 2);
+    bool thrown = false;
+    try
+    {
+        arr.push_back(4);
+    }
+    catch (const length_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "NodePool tests: OK\n";
+}
+
+static void test_btree_bulk_load()
+{
+    header("BTree: Bulk load from sorted input");
+
+    for (double fill : {1.0, 0.75, 0.5, 0.1})
+    {
+        for (int n = 0; n <= 300; n += (n < 20 ? 1 : 37))
+        {
+            Sequence<int> data;
+            for (int i = 0; i < n; ++i)
+                data.push_back(i * 10);
+
+            BTree<int> tree;
+            tree.bulk_load(data, fill);
+            assert(tree.get_size() == static_cast<size_t>(n));
+
+            int expected = 0;
+            for (int k : tree.range(INT_MIN, INT_MAX))
+            {
+                assert(k == expected);
+                expected += 10;
+            }
+            assert(expected == n * 10);
+
+            // tree stays valid for regular inserts afterwards
+            for (int i = 0; i < n; ++i)
+                tree.insert(i * 10 + 5);
+            for (int i = 0; i < n; ++i)
+                assert(tree.contains(i * 10) && tree.contains(i * 10 + 5));
+        }
+    }
+
+    Sequence<int> unsorted;
+    unsorted.push_back(2);
+    unsorted.push_back(1);
+    bool thrown = false;
+    BTree<int> tree;
+    try
+    {
+        tree.bulk_load(unsorted);
+    }
+    catch (const invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "BTree bulk load tests: OK\n";
+}
+
+static void test_eytzinger_index()
+{
+    header("EytzingerIndex tests");
+
+    for (int n = 0; n <= 1100; n += (n < 40 ? 1 : 97))
+    {
+        Sequence<int> data;
+        for (int i = 0; i < n; ++i)
+            data.push_back(i * 2);
+
+        EytzingerIndex<int> idx(data);
+        assert(idx.get_size() == static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i)
+        {
+            const int *p = idx.search(i * 2);
+            assert(p && *p == i * 2);
+            assert(!idx.contains(i * 2 + 1));
+            // lower_bound of an odd key is the next even one
+            const int *lb = idx.lower_bound(i * 2 - 1);
+            assert(lb && *lb == i * 2);
+        }
+        assert(!idx.contains(-1));
+        assert(idx.lower_bound(n * 2) == nullptr);
+    }
+
+    Sequence<int> unsorted;
+    unsorted.push_back(3);
+    unsorted.push_back(1);
+    bool thrown = false;
+    try
+    {
+        EytzingerIndex<int> bad(unsorted);
+    }
+    catch (const invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // as CacheManager storage: keys outside all_data's range go to the index
+    Sequence<int> data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(i * 10);
+    CacheManager<int> cache(10);
+    cache.set_storage_index(StorageIndex::Eytzinger);
+    cache.initialize(data);
+    assert(cache.get_storage_size() == 100);
+    int *v = cache.get(500);
+    assert(v && *v == 500);
+    assert(cache.get(505) == nullptr);
+
+    SlowStorage<int> store;
+    store.set_index(StorageIndex::Eytzinger);
+    store.load(unsorted);
+    assert(store.contains(1) && store.contains(3) && !store.contains(2));
+    thrown = false;
+    try
+    {
+        store.insert(5);
+    }
+    catch (const logic_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "EytzingerIndex tests: OK\n";
+}
+
+static void test_btree_erase()
+{
+    header("BTree: Erase with rebalancing");
+
+    BTree<int> tree;
+    set<int> model;
+    mt19937 gen(99);
+    uniform_int_distribution<> dist(0, 999);
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        int k = dist(gen);
+        if (gen() % 2 && !model.count(k))
+        {
+            tree.insert(k);
+            model.insert(k);
+        }
+        else
+        {
+            bool erased = tree.erase(k);
+            assert(erased == (model.erase(k) == 1));
+        }
+        assert(tree.get_size() == model.size());
+
+        if (step % 1000 == 0)
+        {
+            auto it = model.begin();
+            for (int x : tree.range(INT_MIN, INT_MAX))
+                assert(it != model.end() && x == *it++);
+            assert(it == model.end());
+        }
+    }
+
+    // draining the tree releases every node but the root
+    for (int k : vector<int>(model.begin(), model.end()))
+        assert(tree.erase(k));
+    assert(tree.get_size() == 0 && tree.get_node_count() == 1);
+    assert(!tree.erase(1));
+
+    // erase also works on bulk-loaded trees
+    Sequence<int> data;
+    for (int i = 0; i < 500; ++i)
+        data.push_back(i);
+    tree.bulk_load(data);
+    for (int i = 0; i < 500; i += 2)
+        assert(tree.erase(i));
+    for (int i = 0; i < 500; ++i)
+        assert(tree.contains(i) == (i % 2 == 1));
+
+    cout << "BTree erase tests: OK\n";
+}
+
+static void test_btree_range()
+{
+    header("BTree: Ordered iteration & range scans");
+
+    BTree<int> empty;
+    assert(empty.begin() == empty.end());
+
+    BTree<int> tree;
+    vector<int> keys;
+    for (int i = 0; i < 1000; ++i)
+        keys.push_back(i * 2);
+    mt19937 gen(7);
+    shuffle(keys.begin(), keys.end(), gen);
+    for (int k : keys)
+        tree.insert(k);
+
+    int expected = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it)
+    {
+        assert(*it == expected);
+        expected += 2;
+    }
+    assert(expected == 2000);
+
+    // bounds that fall between keys
+    int count = 0;
+    expected = 102;
+    for (int k : tree.range(101, 301))
+    {
+        assert(k == expected);
+        expected += 2;
+        count++;
+    }
+    assert(count == 100);
+
+    assert(*tree.lower_bound(500) == 500);
+    assert(*tree.lower_bound(501) == 502);
+    assert(tree.lower_bound(5000) == tree.end());
+    assert(tree.range(3000, 4000).begin() == tree.end());
+
+    // the iterator keeps its own copy of the bound after the Range is gone
+    count = 0;
+    for (auto it = tree.range(101, 301).begin(); !it.at_end(); ++it)
+        count++;
+    assert(count == 100);
+
+    // B+tree leaf-linked range
+    BPlusTree<int, int, 64> bp;
+    for (int k : keys)
+        bp.insert(k, -k);
+    count = 0;
+    for (auto it = bp.range(101, 301); !it.at_end(); ++it, ++count)
+        assert(it.key() == 102 + 2 * count && it.value() == -it.key());
+    assert(count == 100);
+
+    cout << "BTree range tests: OK\n";
+}
+
+// Key/payload separated index tests
+static void test_record_index()
+{
+    header("RecordIndex: Key-only index over record heap");
+
+    RecordIndex<Person> idx;
+    for (int i = 0; i < 300; ++i)
+        idx.insert(Person((i * 37) % 300, "name" + to_string(i), i, "e@x.org"));
+    assert(idx.get_size() == 300);
+
+    Person *p = idx.search(37);
+    assert(p && p->id == 37 && p->name == "name1");
+    assert(!idx.search(1000));
+
+    idx.insert(Person(37, "updated", 1, "u@x.org"));
+    assert(idx.get_size() == 300 && idx.search(37)->name == "updated");
+
+    assert(idx.erase(37) && !idx.contains(37) && !idx.erase(37));
+    idx.insert(Person(1000, "reused", 2, "r@x.org"));
+    assert(idx.search(1000)->name == "reused");
+    assert(idx.heap_memory_bytes() >= 300 * sizeof(Person));
+
+    cout << "RecordIndex tests: OK\n";
+}
+
+// B+tree tests
+static void test_bplustree_basic()
+{
+    header("BPlusTree: Insert & Search");
+
+    // small nodes force many leaf and inner splits
+    BPlusTree<int, int, 64> tree;
+    vector<int> keys(5000);
+    for (int i = 0; i < 5000; ++i)
+        keys[i] = i * 3 - 7000;
+    mt19937 gen(42);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    for (int k : keys)
+        tree.insert(k, k * 2);
+    assert(tree.get_size() == keys.size());
+    assert(tree.get_height() > 2);
+
+    for (int k : keys)
+    {
+        int *v = tree.find(k);
+        assert(v && *v == k * 2);
+        assert(!tree.contains(k + 1));
+    }
+    assert(!tree.contains(INT32_MIN) && !tree.contains(INT32_MAX));
+
+    tree.insert(keys[0], -1);
+    assert(*tree.find(keys[0]) == -1 && tree.get_size() == keys.size());
+
+    // scalar path for non-int keys
+    BPlusTree<long long, int> wide;
+    for (long long k = 1000; k > 0; --k)
+        wide.insert(k * 1000000000LL, static_cast<int>(k));
+    for (long long k = 1; k <= 1000; ++k)
+        assert(*wide.find(k * 1000000000LL) == k);
+
+    cout << "BPlusTree basic tests: OK\n";
+}
+
+// Persistent paged B+tree tests
+static void test_paged_btree()
+{
+    header("PagedBTree: Persistent pages & buffer pool");
+
+    string path = (filesystem::temp_directory_path() / "paged_btree_test.db").string();
+    filesystem::remove(path);
+
+    vector<int> keys(20000);
+    for (int i = 0; i < 20000; ++i)
+        keys[i] = i * 5;
+    mt19937 gen(11);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    {
+        // tiny pool forces evictions and write-backs during the build
+        PagedBTree<CompactPerson> tree(path, 8);
+        for (int k : keys)
+        {
+            CompactPerson p;
+            p.id = k;
+            p.age = k % 90;
+            tree.insert(k, p);
+        }
+        assert(tree.get_size() == keys.size());
+        assert(tree.get_height() >= 2);
+        assert(tree.get_pool_statistics().evictions > 0);
+        tree.flush();
+    }
+
+    // reopen: no rebuild, everything is read back from pages
+    {
+        PagedBTree<CompactPerson> tree(path, 16);
+        assert(tree.get_size() == keys.size());
+        for (int k : keys)
+        {
+            CompactPerson p;
+            assert(tree.find(k, p) && p.id == k && p.age == k % 90);
+            assert(!tree.contains(k + 1));
+        }
+        CompactPerson updated;
+        updated.id = keys[0];
+        updated.age = 7;
+        tree.insert(keys[0], updated);
+        assert(tree.get_size() == keys.size());
+        tree.flush();
+    }
+    {
+        PagedBTree<CompactPerson> tree(path, 4);
+        CompactPerson p;
+        assert(tree.find(keys[0], p) && p.age == 7);
+    }
+
+    bool thrown = false;
+    try
+    {
+        PagedBTree<int> wrong(path, 4);
+    }
+    catch (const runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    filesystem::remove(path);
+
+    cout << "PagedBTree tests: OK\n";
+}
+
+// Concurrent B-tree tests
+static void test_concurrent_btree()
+{
+    header("ConcurrentBTree: Optimistic lock coupling");
+
+    ConcurrentBTree<int, int, 128> tree;
+    const int THREADS = 4;
+    const int PER_THREAD = 20000;
+    atomic<bool> stop(false);
+    atomic<size_t> bad_reads(0);
+
+    // reader checks that any key it sees carries its own value
+    thread reader([&]
+                  {
+        mt19937 gen(5);
+        while (!stop.load())
+        {
+            int k = static_cast<int>(gen() % (THREADS * PER_THREAD));
+            int v = 0;
+            if (tree.find(k, v) && v != -k)
+                bad_reads++;
+        } });
+
+    vector<thread> writers;
+    for (int t = 0; t < THREADS; ++t)
+        writers.emplace_back([&tree, t]
+                             {
+            for (int i = 0; i < PER_THREAD; ++i)
+            {
+                int k = i * THREADS + t;
+                tree.insert(k, -k);
+            } });
+    for (auto &w : writers)
+        w.join();
+    stop = true;
+    reader.join();
+
+    assert(bad_reads == 0);
+    assert(tree.get_size() == static_cast<size_t>(THREADS * PER_THREAD));
+    for (int k = 0; k < THREADS * PER_THREAD; ++k)
+    {
+        int v = 0;
+        assert(tree.find(k, v) && v == -k);
+    }
+    assert(!tree.contains(-1));
+
+    tree.insert(10, 99);
+    int v = 0;
+    assert(tree.find(10, v) && v == 99 && tree.get_size() == static_cast<size_t>(THREADS * PER_THREAD));
+
+    cout << "ConcurrentBTree tests: OK\n";
+}
+
+static void test_concurrent_dictionary()
+{
+    header("ConcurrentDictionary: striped writes, lock-free reads");
+
+    {
+        ConcurrentDictionary<int, string> dict;
+        for (int i = 0; i < 1000; ++i)
+            dict.insert(i, "v" + to_string(i));
+        assert(dict.get_size() == 1000 && dict.get_capacity() >= 1024);
+
+        string s;
+        assert(dict.find(500, s) && s == "v500");
+        dict.insert(500, "updated");
+        assert(dict.find(500, s) && s == "updated" && dict.get_size() == 1000);
+        assert(dict.erase(500) && !dict.erase(500) && !dict.contains(500));
+        assert(dict.get_size() == 999 && dict.get_all_entries().get_size() == 999);
+
+        dict.clear();
+        assert(dict.get_size() == 0 && !dict.contains(1));
+        dict.insert(1, "one");
+        assert(dict.find(1, s) && s == "one");
+    }
+
+    // replaced and erased nodes are freed once the epoch has moved on
+    {
+        int live_before = Tracked::live;
+        {
+            ConcurrentDictionary<int, Tracked> dict;
+            for (int i = 0; i < 300; ++i)
+                dict.insert(i, Tracked(i));
+            for (int i = 0; i < 300; i += 2)
+                dict.insert(i, Tracked(-i));
+            for (int i = 1; i < 300; i += 2)
+                dict.erase(i);
+            Tracked t;
+            assert(dict.find(4, t) && t.value == -4 && !dict.contains(5));
+        }
+        for (int i = 0; i < 3; ++i)
+            EpochManager::instance().try_reclaim();
+        assert(EpochManager::instance().get_pending() == 0);
+        assert(Tracked::live == live_before);
+    }
+
+    // readers run through concurrent inserts, updates, erases and resizes
+    {
+        ConcurrentDictionary<int, int> dict;
+        const int THREADS = 4;
+        const int PER_THREAD = 20000;
+        atomic<bool> stop(false);
+        atomic<size_t> bad_reads(0);
+
+        vector<thread> readers;
+        for (int r = 0; r < 2; ++r)
+            readers.emplace_back([&, r]
+                                 {
+                mt19937 gen(40 + r);
+                while (!stop.load())
+                {
+                    int k = static_cast<int>(gen() % (THREADS * PER_THREAD));
+                    int v = 0;
+                    if (dict.find(k, v) && v != 2 * k && v != 3 * k)
+                        bad_reads++;
+                } });
+
+        vector<thread> writers;
+        for (int t = 0; t < THREADS; ++t)
+            writers.emplace_back([&dict, t]
+                                 {
+                for (int i = 0; i < PER_THREAD; ++i)
+                    dict.insert(i * THREADS + t, 2 * (i * THREADS + t));
+                for (int i = 0; i < PER_THREAD; ++i)
+                {
+                    int k = i * THREADS + t;
+                    if (k % 2 == 0)
+                        dict.erase(k);
+                    else
+                        dict.insert(k, 3 * k);
+                } });
+        for (auto &w : writers)
+            w.join();
+        stop = true;
+        for (auto &r : readers)
+            r.join();
+
+        assert(bad_reads == 0);
+        assert(dict.get_size() == static_cast<size_t>(THREADS * PER_THREAD / 2));
+        for (int k = 0; k < THREADS * PER_THREAD; ++k)
+        {
+            int v = 0;
+            assert(k % 2 == 0 ? !dict.contains(k) : dict.find(k, v) && v == 3 * k);
+        }
+        // writers overlap their erase phase with others' inserts, so the peak size
+        // varies; the last insert saw at least the final size and grew for it
+        assert(static_cast<double>(dict.get_size()) < dict.get_capacity() * 0.75);
+    }
+
+    cout << "ConcurrentDictionary tests: OK\n";
+}
+
 // LFU Cache tests
 static void test_cache_lfu_behavior()
 {
@@ -156,6 +1216,39 @@ static void test_cache_lfu_behavior()
     cout << "Cache LFU behavior tests: OK\n";
 }
 
+static void test_cache_put_invalidate()
+{
+    header("CacheManager: put and invalidate");
+
+    Sequence<int> data;
+    for (int i = 0; i < 10; ++i)
+        data.push_back(i);
+
+    CacheManager<int> cache(3);
+    cache.initialize(data); // preloads 0..2
+
+    // overwrite a cached key: later reads see the new value, backing data is unchanged
+    cache.put(1, 100);
+    assert(*cache.get(1) == 100);
+    assert(cache.get_cache_size() == 3);
+
+    // a new key evicts when full and is served as a hit afterwards
+    cache.put(7, 700);
+    assert(cache.get_cache_size() == 3);
+    size_t hits = cache.get_statistics().hits;
+    assert(*cache.get(7) == 700);
+    assert(cache.get_statistics().hits == hits + 1);
+
+    // invalidate drops the written value; the next read reloads the record
+    assert(cache.invalidate(1));
+    assert(cache.get_cache_entry(1) == nullptr);
+    assert(!cache.invalidate(1));
+    assert(*cache.get(1) == 1);
+    assert(cache.get_cache_size() <= cache.get_max_cache_size());
+
+    cout << "Cache put/invalidate tests: OK\n";
+}
+
 // Cache statistical tests and stress
 static void test_cache_stats_and_stress()
 {
@@ -188,7 +1281,512 @@ static void test_cache_stats_and_stress()
     cout << "Cache stats & stress tests: OK\n";
 }
 
+// Compact Person encoding tests
+static void test_compact_person()
+{
+    header("CompactPerson: String interning");
+
+    StringPool pool;
+    assert(pool.intern("") == 0);
+    uint32_t a = pool.intern("gmail.com");
+    uint32_t b = pool.intern(string("gmail.") + "com");
+    assert(a == b && pool.view(a) == "gmail.com");
+
+    Person p1(1, "Anna", 30, "anna@gmail.com");
+    Person p2(2, "Anna", 31, "ivan@gmail.com");
+    CompactPerson c1(p1, pool), c2(p2, pool);
+    assert(c1.name_id == c2.name_id);
+    assert(c1.email_domain_id == c2.email_domain_id);
+    assert(c1.to_person(pool).email == "anna@gmail.com");
+    assert(c2.to_person(pool).name == "Anna");
+
+    // no '@' round-trips unchanged
+    CompactPerson c3(Person(3, "X", 1, "local-only"), pool);
+    assert(c3.email(pool) == "local-only");
+
+    // cache stores compact records
+    Sequence<CompactPerson> data;
+    for (int i = 0; i < 20; ++i)
+        data.push_back(CompactPerson(Person(i, "N", 20, "u" + to_string(i) + "@mail.ru"), pool));
+    CacheManager<CompactPerson> cache(5);
+    cache.initialize(data);
+    CompactPerson *v = cache.get(12);
+    assert(v && v->id == 12 && v->email(pool) == "u12@mail.ru");
+
+    cout << "CompactPerson tests: OK\n";
+}
+
+// Disk tier tests
+static void test_mapped_sequence()
+{
+    header("MappedSequence tests");
+
+    string path = (filesystem::temp_directory_path() / "mapped_sequence_test.bin").string();
+
+    Sequence<CompactPerson> records;
+    for (int i = 0; i < 5000; ++i)
+    {
+        CompactPerson p(i);
+        p.age = i % 90;
+        records.push_back(p);
+    }
+    MappedSequence<CompactPerson>::write_file(path, records);
+
+    {
+        MappedSequence<CompactPerson> view(path);
+        assert(view.is_open() && view.get_size() == 5000);
+        for (int i = 0; i < 5000; ++i)
+            assert(view[i].id == i && view[i].age == i % 90);
+
+        bool thrown = false;
+        try
+        {
+            view[5000];
+        }
+        catch (const out_of_range &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // CacheManager serves misses from the mapping without copying it
+    CacheManager<CompactPerson> cache(100);
+    cache.initialize_mapped(path);
+    assert(cache.is_mapped() && cache.get_storage_size() == 5000);
+    assert(cache.get_cache_size() == 100);
+    for (int k = 4000; k < 4300; ++k)
+    {
+        CompactPerson *p = cache.get(k);
+        assert(p && p->id == k && p->age == k % 90);
+    }
+    assert(cache.get(5000) == nullptr);
+    assert(cache.get_cache_size() == 100);
+
+    // back to an in-memory dataset
+    Sequence<CompactPerson> small;
+    small.push_back(CompactPerson(0));
+    cache.initialize(small);
+    assert(!cache.is_mapped() && cache.get_storage_size() == 1);
+
+    // file size must be a whole number of records
+    {
+        ofstream bad(path, ios::binary | ios::trunc);
+        bad << "abc";
+    }
+    bool thrown = false;
+    try
+    {
+        MappedSequence<CompactPerson> view(path);
+    }
+    catch (const runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    filesystem::remove(path);
+
+    cout << "MappedSequence tests: OK\n";
+}
+
+static void test_cache_disk_tier()
+{
+    header("CacheManager: Disk-backed L2 tier");
+
+    string dir = (filesystem::temp_directory_path() / "cache_l2_test").string();
+
+    // direct segment/compaction behaviour
+    {
+        DiskTier<Person> tier(dir, 256, 4);
+        for (int i = 0; i < 40; ++i)
+            assert(tier.put(i % 10, Person(i % 10, "name" + to_string(i), 20 + i, "p@mail.com")));
+        assert(tier.get_size() == 10);
+        Person p;
+        assert(tier.get(7, p) && p.id == 7 && p.name == "name37" && p.email == "p@mail.com");
+        assert(tier.get_segment_count() <= 4);
+        assert(tier.erase(7) && !tier.contains(7));
+    }
+
+    // two tiers sharing a directory must not overwrite each other's segments
+    {
+        DiskTier<Person> a(dir, 256, 4), b(dir, 256, 4);
+        assert(a.put(1, Person(1, "first", 30, "a@mail.com")));
+        assert(b.put(1, Person(1, "second", 40, "b@mail.com")));
+        Person p;
+        assert(a.get(1, p) && p.name == "first");
+        assert(b.get(1, p) && p.name == "second");
+    }
+
+    Sequence<int> data;
+    for (int i = 0; i < 20; ++i)
+        data.push_back(i);
+
+    CacheManager<int> cache(3);
+    cache.enable_disk_tier(dir, 4096, 4);
+    if (!cache.has_disk_tier())
+    {
+        cout << "Disk tier unavailable on this platform, skipped\n";
+        return;
+    }
+    cache.initialize(data);
+
+    for (int i = 3; i < 10; ++i)
+        cache.get(i);
+    auto s = cache.get_statistics();
+    assert(s.l2_writes == s.evictions);
+    assert(cache.get_disk_tier_size() > 0);
+
+    // evicted key 0 comes back from L2 and is promoted into memory
+    int *v = cache.get(0);
+    assert(v && *v == 0);
+    assert(cache.get_statistics().l2_hits == 1);
+    assert(cache.get_cache_entry(0) != nullptr);
+
+    cout << "Disk tier tests: OK\n";
+}
+
 // Benchmark smoke test
+static void test_slow_storage()
+{
+    header("SlowStorage tests");
+
+    Sequence<int> data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(i);
+
+    // constant latency: every request waits at least that long
+    SlowStorage<int> store(LatencyModel::constant(200.0), 1, WaitMode::Spin);
+    store.load(data);
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i)
+        assert(store.contains(i));
+    assert(!store.contains(1000));
+    auto t2 = chrono::steady_clock::now();
+    assert(chrono::duration_cast<chrono::microseconds>(t2 - t1).count() >= 11 * 200);
+    assert(store.search(42) && *store.search(42) == 42);
+    SlowStorageStats st = store.get_statistics();
+    assert(st.requests == 13);
+    assert(st.total_latency_us == 13 * 200.0);
+
+    // distributions: lognormal median and bimodal slow share
+    mt19937_64 gen(7);
+    LatencyModel ln = LatencyModel::lognormal(100.0, 0.5);
+    vector<double> samples(20001);
+    for (auto &x : samples)
+        x = ln.sample(gen);
+    nth_element(samples.begin(), samples.begin() + 10000, samples.end());
+    assert(samples[10000] > 90.0 && samples[10000] < 110.0);
+
+    LatencyModel bi = LatencyModel::bimodal(10.0, 1000.0, 0.1);
+    int slow = 0;
+    for (int i = 0; i < 20000; ++i)
+        slow += bi.sample(gen) == 1000.0;
+    assert(slow > 1700 && slow < 2300);
+
+    bool thrown = false;
+    try
+    {
+        SlowStorage<int> bad(LatencyModel::none(), 0);
+    }
+    catch (const invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // queue depth bounds the number of requests in flight
+    SlowStorage<int> shared(LatencyModel::constant(2000.0), 2, WaitMode::Sleep);
+    shared.load(data);
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&shared]
+                             {
+            for (int i = 0; i < 5; ++i)
+                shared.contains(i); });
+    for (auto &th : threads)
+        th.join();
+    st = shared.get_statistics();
+    assert(st.requests == 20);
+    assert(st.max_in_flight <= 2);
+    assert(st.total_queue_us > 0.0);
+
+    // cache misses pay the configured storage latency
+    CacheManager<int> cache(10);
+    cache.set_storage_latency(LatencyModel::constant(50.0));
+    cache.initialize(data);
+    for (int i = 0; i < 30; ++i)
+        cache.get(i);
+    assert(cache.get_storage_statistics().requests == cache.get_statistics().misses);
+    assert(cache.get_statistics().avg_access_time_storage >= 0.05);
+
+    cout << "SlowStorage tests: OK\n";
+}
+
+static void test_benchmark_stats()
+{
+    header("Benchmark: Repetition statistics");
+
+    SampleStats s = SampleStats::from({5.0, 1.0, 3.0, 2.0, 4.0});
+    assert(s.count == 5);
+    assert(s.median == 3.0 && s.mean == 3.0);
+    assert(s.min == 1.0 && s.max == 5.0);
+    assert(abs(s.stddev - sqrt(2.5)) < 1e-12);
+    // t(4) = 2.776
+    assert(abs((s.ci95_high - s.mean) - 2.776 * s.stddev / sqrt(5.0)) < 1e-9);
+    assert(abs((s.mean - s.ci95_low) - (s.ci95_high - s.mean)) < 1e-12);
+
+    assert(SampleStats::from({4.0, 1.0, 2.0, 3.0}).median == 2.5);
+
+    SampleStats one = SampleStats::from({7.0});
+    assert(one.stddev == 0.0 && one.ci95_low == 7.0 && one.ci95_high == 7.0);
+    assert(SampleStats::from({}).count == 0);
+
+    const char *good[] = {"bench", "--reps", "3", "--seed", "7", "--filter", "cache"};
+    BenchmarkHarness::Options o = BenchmarkHarness::parse_args(7, const_cast<char **>(good));
+    assert(o.repetitions == 3 && o.seed == 7 && o.filter == "cache");
+
+    auto rejects = [](vector<const char *> args)
+    {
+        try
+        {
+            BenchmarkHarness::parse_args(static_cast<int>(args.size()), const_cast<char **>(args.data()));
+        }
+        catch (const invalid_argument &)
+        {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects({"bench", "--reps", "0"}));
+    assert(rejects({"bench", "--reps", "3x"}));
+    assert(rejects({"bench", "--seed"}));
+    assert(rejects({"bench", "--fast"}));
+
+    cout << "Benchmark stats tests: OK\n";
+}
+
+static void test_workloads()
+{
+    header("Benchmark: Workloads and access traces");
+
+    // skew 1: rank 0 is twice as likely as rank 1, ten times as rank 9
+    ZipfDistribution zipf(1000, 1.0);
+    assert(abs(zipf.probability(0) / zipf.probability(1) - 2.0) < 1e-9);
+    assert(abs(zipf.probability(0) / zipf.probability(9) - 10.0) < 1e-9);
+    mt19937 gen(1);
+    vector<int> counts(1000, 0);
+    for (int i = 0; i < 200000; ++i)
+        counts[zipf(gen)]++;
+    assert(abs(counts[0] / 200000.0 - zipf.probability(0)) < 0.01);
+    assert(counts[0] > counts[1] && counts[1] > counts[10] && counts[10] > counts[500]);
+    assert(abs(ZipfDistribution(10, 0.0).probability(3) - 0.1) < 1e-12);
+
+    Workload w(100, 7);
+    w.scan(150, 90).loop(30, 10).zipf(1000, 1.2).shifting_hotspot(1000, 5, 1.0, 100).uniform(50);
+    const Sequence<int> &keys = w.keys();
+    assert(keys.get_size() == 150 + 30 + 1000 + 1000 + 50);
+    assert(w.get_phases().size() == 5);
+    assert(w.get_phases()[2].name == "zipf-1.20");
+    assert(keys[0] == 90 && keys[9] == 99 && keys[10] == 0 && keys[149] == 39);
+    for (size_t i = 150; i < 180; ++i)
+        assert(keys[i] == static_cast<int>((i - 150) % 10));
+    for (int k : keys)
+        assert(k >= 0 && k < 100);
+
+    // a hotspot phase with hot fraction 1 stays inside 5 keys per period, and moves
+    set<int> first, second;
+    for (size_t i = 1180; i < 1280; ++i)
+        first.insert(keys[i]);
+    for (size_t i = 1280; i < 1380; ++i)
+        second.insert(keys[i]);
+    assert(first.size() <= 5 && second.size() <= 5);
+    for (int k : first)
+        assert(!second.count(k));
+
+    Workload same(100, 7);
+    same.scan(150, 90).loop(30, 10).zipf(1000, 1.2);
+    for (size_t i = 0; i < same.get_size(); ++i)
+        assert(same.keys()[i] == keys[i]);
+
+    bool thrown = false;
+    try
+    {
+        w.loop(10, 101);
+    }
+    catch (const invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // binary trace round trip, including negative keys and large jumps
+    string path = (filesystem::temp_directory_path() / "access_trace_test.bin").string();
+    Sequence<int> trace = keys;
+    trace.push_back(INT_MIN);
+    trace.push_back(INT_MAX);
+    trace.push_back(-1);
+    AccessTrace::write(path, trace);
+    // a scan-heavy trace stays well below 4 bytes per key
+    assert(filesystem::file_size(path) < 16 + 2 * trace.get_size());
+    Sequence<int> back = AccessTrace::read(path);
+    assert(back.get_size() == trace.get_size());
+    for (size_t i = 0; i < trace.get_size(); ++i)
+        assert(back[i] == trace[i]);
+
+    AccessTrace::write(path, Sequence<int>());
+    assert(AccessTrace::read(path).get_size() == 0);
+
+    // truncated file
+    AccessTrace::write(path, keys);
+    filesystem::resize_file(path, filesystem::file_size(path) - 1);
+    thrown = false;
+    try
+    {
+        AccessTrace::read(path);
+    }
+    catch (const runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    {
+        ofstream text(path);
+        text << "1000\n\n-5\n1000\n 42 \n";
+    }
+    Sequence<int> ids = AccessTrace::read_text(path);
+    assert(ids.get_size() == 4 && ids[1] == -5 && ids[3] == 42);
+    thrown = false;
+    try
+    {
+        AccessTrace::read(path);
+    }
+    catch (const runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    filesystem::remove(path);
+
+    assert(AccessTrace::compact_keys(ids) == 3);
+    assert(ids[0] == 0 && ids[1] == 1 && ids[2] == 0 && ids[3] == 2);
+
+    // replaying a loop one key longer than the cache: LFU keeps the preloaded keys
+    Sequence<int> data;
+    for (int i = 0; i < 100; ++i)
+        data.push_back(i);
+    CacheManager<int> cache(10);
+    cache.initialize(data);
+    Workload loop(100);
+    loop.loop(110, 11);
+    ReplayResult r = replay_trace(cache, loop.keys());
+    assert(r.requests == 110 && r.hits + r.misses == 110);
+    assert(r.hits == cache.get_statistics().hits);
+    ReplayResult tail = replay_trace(cache, loop.keys(), 100);
+    assert(tail.requests == 10);
+
+    cout << "Workload tests: OK\n";
+}
+
+static int *volatile memory_test_escape = nullptr;
+
+static void test_memory_accounting()
+{
+    header("Benchmark: Heap accounting");
+
+    if (!memory_accounting_exact())
+    {
+        cout << "Memory accounting tests: skipped (no malloc_usable_size)\n";
+        return;
+    }
+
+    MemoryScope scope;
+    int *block = new int[1000];
+    memory_test_escape = block; // keep the compiler from eliding the pair
+    MemoryUsage held = scope.report();
+    assert(held.allocations == 1 && held.deallocations == 0);
+    assert(held.retained_bytes >= 1000 * sizeof(int) && held.retained_bytes < 1000 * sizeof(int) + 64);
+    assert(held.peak_bytes >= held.retained_bytes);
+    delete[] block;
+    MemoryUsage freed = scope.report();
+    assert(freed.deallocations == 1 && freed.retained_bytes == 0);
+    assert(freed.peak_bytes == held.peak_bytes);
+
+    // a container's footprint covers at least its payload and is all given back
+    MemoryScope dict_scope;
+    {
+        Dictionary<int, int> dict;
+        for (int i = 0; i < 10000; ++i)
+            dict.insert(i, i);
+        MemoryUsage u = dict_scope.report();
+        assert(u.retained_bytes >= 10000 * 2 * sizeof(int));
+        assert(u.peak_bytes >= u.retained_bytes && u.allocations > 1);
+    }
+    assert(dict_scope.report().retained_bytes == 0);
+
+    // over-aligned objects go through the aligned operator new and are counted too
+    MemoryScope aligned_scope;
+    {
+        unique_ptr<ConcurrentDictionary<int, int>> dict(new ConcurrentDictionary<int, int>());
+        dict->insert(1, 1);
+        assert(aligned_scope.report().retained_bytes >= sizeof(ConcurrentDictionary<int, int>));
+    }
+    assert(aligned_scope.report().retained_bytes == 0);
+
+    cout << "Memory accounting tests: OK\n";
+}
+
+static void test_perf_counters()
+{
+    header("Benchmark: Performance counter scopes");
+
+    PerfCounters &perf = PerfCounters::session();
+
+    // switched off, scopes are no-ops and nothing is reported
+    perf.disable();
+    {
+        PerfCounterScope scope;
+    }
+    assert(perf.take().regions == 0);
+    assert(BenchmarkHarness::take_perf_counters().empty());
+
+    bool available = perf.enable();
+    assert(available == !perf.available_events().empty());
+    if (!available)
+    {
+        cout << "Perf counter tests: OK (no counters here, fallback only)\n";
+        return;
+    }
+
+    // nested scopes count once
+    {
+        PerfCounterScope outer;
+        PerfCounterScope inner;
+        Sequence<int> work;
+        for (int i = 0; i < (1 << 20); ++i)
+            work.push_back(i);
+        memory_test_escape = work.begin();
+    }
+    PerfCounters::Sample s = perf.take();
+    assert(s.regions == 1);
+    for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e)
+        assert(!s.valid[e] || s.value[e] >= 0.0);
+    assert(perf.take().regions == 0);
+
+    double ms = BenchmarkHarness::time_ms([]
+                                          { memory_test_escape = nullptr; });
+    Measurements m = BenchmarkHarness::take_perf_counters();
+    assert(ms >= 0.0 && !m.empty());
+    for (const Measurement &x : m)
+        assert(x.metric.compare(0, 5, "perf_") == 0);
+
+    cout << "Perf counter tests: OK (";
+    for (const string &e : perf.available_events())
+        cout << e << (e == perf.available_events().back() ? "" : ", ");
+    cout << ")\n";
+    perf.disable();
+}
+
 static void test_benchmark_smoke()
 {
     header("Benchmark: Smoke test (runs small benchmark)");
@@ -210,13 +1808,13 @@ static void test_benchmark_smoke()
     auto t2 = chrono::high_resolution_clock::now();
     double cache_ms = chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
 
-    BTree<int> tree;
+    SlowStorage<int> store(LatencyModel::constant(20.0));
     for (int i = 0; i < 500; ++i)
-        tree.insert(i);
+        store.insert(i);
 
     t1 = chrono::high_resolution_clock::now();
     for (int k : pattern)
-        tree.search_slow(k);
+        store.contains(k);
     t2 = chrono::high_resolution_clock::now();
     double store_ms = chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
 
@@ -230,10 +1828,35 @@ void run_all_tests()
 {
     cout << "\n==== RUNNING FULL TEST SUITE ====\n";
     test_sequence_basic();
+    test_sequence_move();
+    test_small_sequence();
+    test_segmented_sequence();
+    test_parallel_algorithms();
+    test_simd_search();
     test_dictionary_basic();
+    test_dictionary_bulk();
     test_btree_basic();
+    test_bplustree_basic();
+    test_record_index();
+    test_btree_range();
+    test_node_pool();
+    test_btree_bulk_load();
+    test_eytzinger_index();
+    test_btree_erase();
+    test_concurrent_btree();
+    test_concurrent_dictionary();
+    test_paged_btree();
     test_cache_lfu_behavior();
+    test_cache_put_invalidate();
     test_cache_stats_and_stress();
+    test_cache_disk_tier();
+    test_mapped_sequence();
+    test_slow_storage();
+    test_compact_person();
     test_benchmark_smoke();
+    test_benchmark_stats();
+    test_workloads();
+    test_memory_accounting();
+    test_perf_counters();
     cout << "\n===== ALL TESTS PASSED SUCCESSFULLY =====\n";
 }
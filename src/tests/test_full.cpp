@@ -17,8 +17,8 @@ using namespace std;
 // ---------- Утилиты ----------
 static string okfail(bool ok) { return ok ? "OK" : "FAIL"; }
 
-template <typename T>
-static void print_sequence_inline(const Sequence<T> &s)
+template <typename Seq>
+static void print_sequence_inline(const Seq &s)
 {
     for (size_t i = 0; i < s.get_size(); ++i)
     {
@@ -28,12 +28,12 @@ static void print_sequence_inline(const Sequence<T> &s)
     }
 }
 
-static void print_keys_inline(const Sequence<int> &s)
+static void print_keys_inline(const CacheManager<int>::KeyList &s)
 {
     print_sequence_inline(s);
 }
 
-static set<int> seq_to_set(const Sequence<int> &s)
+static set<int> seq_to_set(const CacheManager<int>::KeyList &s)
 {
     set<int> st;
     for (size_t i = 0; i < s.get_size(); ++i)
@@ -113,12 +113,12 @@ static void dictionary_tests()
     dict.insert(30, "thirty");
 
     cout << "All entries (key:value):\n";
-    auto entries = dict.get_all_entries();
-    for (size_t i = 0; i < entries.get_size(); ++i)
+    size_t printed = 0;
+    for (const auto &e : dict)
     {
-        cout << entries[i].key << ":" << entries[i].value;
-        if (i + 1 < entries.get_size())
+        if (printed++)
             cout << "  ";
+        cout << e.key << ":" << e.value;
     }
     cout << "\n";
 
@@ -143,14 +143,14 @@ static void dictionary_tests()
         dict.insert(k, "x");
     cout << "get_size() >= 101? actual " << dict.get_size() << " -> " << okfail(dict.get_size() >= 101) << "\n";
 
-    // print bucket-level detail if available (get_all_entries gives flat view)
+    // iteration walks the buckets in place, no copy of the entries
     cout << "Flat entries sample (first 10): ";
-    auto all = dict.get_all_entries();
-    for (size_t i = 0; i < std::min<size_t>(10, all.get_size()); ++i)
+    size_t shown = 0;
+    for (auto it = dict.begin(); it != dict.end() && shown < 10; ++it, ++shown)
     {
-        if (i)
+        if (shown)
             cout << " ";
-        cout << all[i].key << ":" << all[i].value;
+        cout << it->key << ":" << it->value;
     }
     cout << "\n";
 